@@ -0,0 +1,82 @@
+/*
+  This example code will walk you through how to use the SparkFun VEML6030
+  Ambient Light Sensor without any floating point. On boards without an FPU,
+  like the Uno or SAMD21 boards, floating point math is done in software and
+  pulls several kilobytes of extra code into the sketch. 
+
+  To build the library without it, uncomment the line
+  //#define VEML6030_NO_FLOAT
+  at the top of SparkFun_VEML6030_Ambient_Light_Sensor.h. The gain is then set
+  with one of the VEML6030_GAIN values, and the light can be read in
+  milli-lux for more resolution than whole lux. This sketch works with either
+  build, compile it both ways to see the difference in size, and run
+  Example7_Benchmark or extras/benchmark both ways to see the difference in
+  speed. 
+  
+  SparkFun Electronics
+  Date: October 2026
+
+	License: This code is public domain but if you use this and we meet someday, get me a beer! 
+
+	Feel like supporting our work? Buy a board from Sparkfun!
+	https://www.sparkfun.com/products/15436
+
+*/
+
+#include <Wire.h>
+#include "SparkFun_VEML6030_Ambient_Light_Sensor.h"
+
+#define AL_ADDR 0x48
+
+SparkFun_Ambient_Light light(AL_ADDR);
+
+// Possible values: VEML6030_GAIN_1_8, VEML6030_GAIN_1_4, VEML6030_GAIN_1,
+// VEML6030_GAIN_2
+// Both 1/8 and 1/4 should be used in most cases except darker rooms.
+// A gain of 2 should only be used if the sensor will be covered by a dark
+// glass.
+VEML6030_GAIN gain = VEML6030_GAIN_1_8;
+
+// Possible integration times in milliseconds: 800, 400, 200, 100, 50, 25
+// Higher times give higher resolutions and should be used in darker light. 
+int integTime = 100;
+unsigned long milliLux = 0; 
+
+void setup(){
+
+  Wire.begin();
+  Serial.begin(115200);
+
+  if(light.begin())
+    Serial.println("Ready to sense some light!"); 
+  else
+    Serial.println("Could not communicate with the sensor!");
+
+  light.setGain(gain);
+  light.setIntegTime(integTime);
+
+  Serial.println("Reading settings..."); 
+  Serial.print("Integration Time: ");
+  int timeVal = light.readIntegTime();
+  Serial.println(timeVal);
+
+}
+
+void loop(){
+
+  milliLux = light.readLightMilli();
+
+  // Print it as lux with three decimals.
+  Serial.print("Ambient Light Reading: ");
+  Serial.print(milliLux / 1000);
+  Serial.print(".");
+  unsigned long fraction = milliLux % 1000;
+  if (fraction < 100)
+    Serial.print("0");
+  if (fraction < 10)
+    Serial.print("0");
+  Serial.print(fraction);
+  Serial.println(" Lux");  
+  delay(1000);
+
+}
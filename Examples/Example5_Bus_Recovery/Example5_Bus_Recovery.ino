@@ -0,0 +1,79 @@
+/*
+  This example code will walk you through how to keep the SparkFun VEML6030
+  Ambient Light Sensor running in long running deployments. If the sensor
+  stalls the bus, for example by holding SDA low after a brown-out, the library
+  clocks SCL until the bus is free again and restores the sensor's gain,
+  integration time, thresholds and power save mode. Failed attempts back off so
+  that a dead sensor doesn't hog the bus from any other devices on it. 
+  
+  SparkFun Electronics 
+  Date: October 2026
+
+	License: This code is public domain but if you use this and we meet someday, get me a beer! 
+
+	Feel like supporting our work? Buy a board from Sparkfun!
+	https://www.sparkfun.com/products/15436
+
+*/
+
+#include <Wire.h>
+#include "SparkFun_VEML6030_Ambient_Light_Sensor.h"
+
+#define AL_ADDR 0x48
+
+SparkFun_Ambient_Light light(AL_ADDR);
+
+// Possible values: .125, .25, 1, 2
+// Both .125 and .25 should be used in most cases except darker rooms.
+// A gain of 2 should only be used if the sensor will be covered by a dark
+// glass.
+float gain = .125;
+
+// Possible integration times in milliseconds: 800, 400, 200, 100, 50, 25
+// Higher times give higher resolutions and should be used in darker light. 
+int integTime = 100;
+long luxVal = 0; 
+
+void setup(){
+
+  Wire.begin();
+  Serial.begin(115200);
+
+  if(light.begin())
+    Serial.println("Ready to sense some light!"); 
+  else
+    Serial.println("Could not communicate with the sensor!");
+
+  light.setGain(gain);
+  light.setIntegTime(integTime);
+
+  // The pins of the I2C port the sensor is on. They're used to clock the
+  // sensor out of a stuck transfer. Without them the sensor is only
+  // re-initialized. Clearing the bus restarts the I2C port, if the sketch
+  // changed the clock with Wire.setClock() pass it as well, for example
+  // light.enableBusRecovery(SDA, SCL, 400000); 
+  light.enableBusRecovery(SDA, SCL);
+
+}
+
+void loop(){
+
+  luxVal = light.readLight();
+
+  if (light.isHealthy()) {
+    Serial.print("Ambient Light Reading: ");
+    Serial.print(luxVal);
+    Serial.println(" Lux");  
+  }
+  else
+    Serial.println("Sensor is not answering...");
+
+  Serial.print("Recoveries: ");
+  Serial.print(light.getRecoveryCount());
+  Serial.print(" Time spent recovering: ");
+  Serial.print(light.getRecoveryTime());
+  Serial.println("us");
+
+  delay(1000);
+
+}
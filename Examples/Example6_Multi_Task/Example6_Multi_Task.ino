@@ -0,0 +1,91 @@
+/*
+  This example code will walk you through how to share the SparkFun VEML6030
+  Ambient Light Sensor between several tasks on a dual core ESP32. One task
+  reads the light while another changes the gain. A mutex around the bus keeps
+  their register reads and writes from getting mixed up, and readConfig()
+  gives a consistent copy of the settings without waiting on the bus at all.
+  This example requires an ESP32 or another FreeRTOS based board. 
+  
+  SparkFun Electronics 
+  Date: October 2026
+
+	License: This code is public domain but if you use this and we meet someday, get me a beer! 
+
+	Feel like supporting our work? Buy a board from Sparkfun!
+	https://www.sparkfun.com/products/15436
+
+*/
+
+#include <Wire.h>
+#include "SparkFun_VEML6030_Ambient_Light_Sensor.h"
+
+#define AL_ADDR 0x48
+
+SparkFun_Ambient_Light light(AL_ADDR);
+
+// One lock per I2C port, shared by every sensor on it.
+VEML6030_Mutex busLock;
+
+// Possible values: .125, .25, 1, 2
+float gains[] = {.125, .25};
+
+void readTask(void *param){
+
+  for(;;) {
+    long luxVal = light.readLight();
+    Serial.print("Ambient Light Reading: ");
+    Serial.print(luxVal);
+    Serial.println(" Lux");  
+    vTaskDelay(250 / portTICK_PERIOD_MS);
+  }
+
+}
+
+void gainTask(void *param){
+
+  uint8_t i = 0;
+  for(;;) {
+    light.setGain(gains[i]);
+    i = (i + 1) % 2;
+    vTaskDelay(1000 / portTICK_PERIOD_MS);
+  }
+
+}
+
+void setup(){
+
+  Wire.begin();
+  Serial.begin(115200);
+
+  // Set the lock before anything else touches the bus.
+  light.setLock(busLock);
+
+  if(light.begin())
+    Serial.println("Ready to sense some light!"); 
+  else
+    Serial.println("Could not communicate with the sensor!");
+
+  light.setIntegTime(100);
+
+  xTaskCreatePinnedToCore(readTask, "read", 4096, NULL, 1, NULL, 0);
+  xTaskCreatePinnedToCore(gainTask, "gain", 4096, NULL, 1, NULL, 1);
+
+}
+
+void loop(){
+
+  // Doesn't need the bus to know the settings.
+  VEML6030_Config config;
+  light.readConfig(config);
+  Serial.print("Settings register: 0x");
+  Serial.println(config.setting, HEX);
+
+  Serial.print("Lock contention: ");
+  Serial.print(light.getLockContention());
+  Serial.print(" Time waited: ");
+  Serial.print(light.getLockWaitTime());
+  Serial.println("us");
+
+  delay(5000);
+
+}
@@ -0,0 +1,171 @@
+/*
+  This example code measures what each function of the SparkFun VEML6030
+  Ambient Light Sensor library costs, under every gain and integration time
+  setting. For each function it prints the number of I2C transactions, the
+  bytes put on the bus, the time those would take on the bus at 100kHz, 400kHz
+  and 1MHz, and the time the call actually took. The results are printed as
+  CSV: capture the serial output to a file to compare between library
+  versions. 
+
+  The modeled bus time counts nine clocks per byte (eight bits and the ACK)
+  plus two for the start and stop of each transaction, so clock stretching and
+  gaps between bytes are not included. The measured time is everything the
+  call took at the bus speed set below, delays in the library included.
+
+  The sketch itself doesn't use floating point, so it builds the same with
+  VEML6030_NO_FLOAT defined. Run it once with and once without to compare.
+  extras/benchmark has the same benchmark for a Linux host against a
+  simulated sensor, use this sketch to check its timings on a real board.
+  
+  SparkFun Electronics 
+  Date: October 2026
+
+	License: This code is public domain but if you use this and we meet someday, get me a beer! 
+
+	Feel like supporting our work? Buy a board from Sparkfun!
+	https://www.sparkfun.com/products/15436
+
+*/
+
+#include <Wire.h>
+#include "SparkFun_VEML6030_Ambient_Light_Sensor.h"
+
+#define AL_ADDR 0x48
+
+// How often each function is called, the results are per call.
+#define RUNS 10
+
+// Bus speed the measured times are taken at.
+#define BUS_CLOCK 400000
+
+SparkFun_Ambient_Light light(AL_ADDR);
+
+VEML6030_GAIN gains[] = {VEML6030_GAIN_1_8, VEML6030_GAIN_1_4, VEML6030_GAIN_1, VEML6030_GAIN_2};
+const char *gainNames[] = {"0.125", "0.25", "1", "2"};
+int times[] = {25, 50, 100, 200, 400, 800};
+
+VEML6030_GAIN gain;
+const char *gainName;
+int integTime;
+
+// Prints a total over all runs as the value per call, with one decimal.
+void printPerCall(uint32_t total){
+
+  uint32_t tenths = (total * 10) / RUNS;
+  Serial.print(tenths / 10);
+  Serial.print(".");
+  Serial.print(tenths % 10);
+
+}
+
+// Modeled time in microseconds for the bus traffic of all runs.
+uint32_t busTime(uint32_t clock){
+
+  uint32_t bits = (light.getBusBytes() * 9) + (light.getBusTransactions() * 2);
+  return (bits * 1000) / (clock / 1000);
+
+}
+
+void report(const char *name, uint32_t elapsed){
+
+  Serial.print(name);
+  Serial.print(",");
+  Serial.print(gainName);
+  Serial.print(",");
+  Serial.print(integTime);
+  Serial.print(",");
+  printPerCall(light.getBusTransactions());
+  Serial.print(",");
+  printPerCall(light.getBusBytes());
+  Serial.print(",");
+  printPerCall(busTime(100000));
+  Serial.print(",");
+  printPerCall(busTime(400000));
+  Serial.print(",");
+  printPerCall(busTime(1000000));
+  Serial.print(",");
+  printPerCall(elapsed);
+  Serial.println();
+
+}
+
+// Calls the given code RUNS times and reports on it.
+#define BENCH(name, call) {                          \
+  light.resetBusStats();                             \
+  uint32_t start = micros();                         \
+  for (uint8_t run = 0; run < RUNS; run++) { call; } \
+  report(name, micros() - start);                    \
+}
+
+void setup(){
+
+  Wire.begin();
+  Wire.setClock(BUS_CLOCK);
+  Serial.begin(115200);
+
+  if(!light.begin()) {
+    Serial.println("Could not communicate with the sensor!");
+    while(1);
+  }
+
+  Serial.println("method,gain,integ_time,transactions,bytes,bus_us_100k,bus_us_400k,bus_us_1m,measured_us");
+
+  for (uint8_t g = 0; g < 4; g++) {
+    for (uint8_t t = 0; t < 6; t++) {
+
+      gain = gains[g];
+      gainName = gainNames[g];
+      integTime = times[t];
+      light.setGain(gain);
+      light.setIntegTime(integTime);
+
+      BENCH("begin", light.begin());
+      BENCH("setGain", light.setGain(gain));
+      BENCH("readGain", light.readGain());
+      BENCH("setIntegTime", light.setIntegTime(integTime));
+      BENCH("readIntegTime", light.readIntegTime());
+      BENCH("setProtect", light.setProtect(1));
+      BENCH("readProtect", light.readProtect());
+      BENCH("enableInt", light.enableInt());
+      BENCH("disableInt", light.disableInt());
+      BENCH("readIntSetting", light.readIntSetting());
+      BENCH("shutDown", light.shutDown());
+      BENCH("powerOn", light.powerOn());
+      BENCH("enablePowSave", light.enablePowSave());
+      BENCH("disablePowSave", light.disablePowSave());
+      BENCH("readPowSavEnabled", light.readPowSavEnabled());
+      BENCH("setPowSavMode", light.setPowSavMode(1));
+      BENCH("readPowSavMode", light.readPowSavMode());
+      BENCH("readInterrupt", light.readInterrupt());
+      BENCH("setIntLowThresh", light.setIntLowThresh(20));
+      BENCH("readLowThresh", light.readLowThresh());
+      BENCH("setIntHighThresh", light.setIntHighThresh(400));
+      BENCH("readHighThresh", light.readHighThresh());
+      BENCH("readLight", light.readLight());
+      BENCH("readWhiteLight", light.readWhiteLight());
+      BENCH("readLightMilli", light.readLightMilli());
+      BENCH("readWhiteLightMilli", light.readWhiteLightMilli());
+      BENCH("readConfig", VEML6030_Config config; light.readConfig(config));
+      BENCH("recover", light.recover());
+      BENCH("isHealthy", light.isHealthy());
+      BENCH("getFailCount", light.getFailCount());
+      BENCH("getRecoveryCount", light.getRecoveryCount());
+      BENCH("getRecoveryTime", light.getRecoveryTime());
+      BENCH("getLockContention", light.getLockContention());
+      BENCH("getLockWaitTime", light.getLockWaitTime());
+      BENCH("getLastRawLight", light.getLastRawLight());
+      BENCH("getLastSettingsTag", light.getLastSettingsTag());
+      BENCH("getSettingsTag", light.getSettingsTag());
+      BENCH("getSampleCount", light.getSampleCount());
+      BENCH("luxResolution", SparkFun_Ambient_Light::luxResolution(light.getLastSettingsTag()));
+      BENCH("compensateLux", SparkFun_Ambient_Light::compensateLux(5000));
+
+    }
+  }
+
+  Serial.println("done");
+
+}
+
+void loop(){
+}
@@ -0,0 +1,103 @@
+/*
+  This example code will walk you through how to keep track of the spread of
+  light readings on the SparkFun VEML6030 Ambient Light Sensor. Every reading
+  goes into a histogram that takes the same small amount of memory no matter
+  how many readings it holds. Every minute the 5th, 50th and 95th percentile
+  are printed along with a compact snapshot of the whole distribution, which is
+  far less to send off the board than every single reading. 
+  
+  SparkFun Electronics 
+  Date: October 2026
+
+	License: This code is public domain but if you use this and we meet someday, get me a beer! 
+
+	Feel like supporting our work? Buy a board from Sparkfun!
+	https://www.sparkfun.com/products/15436
+
+*/
+
+#include <Wire.h>
+#include "SparkFun_VEML6030_Ambient_Light_Sensor.h"
+#include "SparkFun_VEML6030_Lux_Histogram.h"
+
+#define AL_ADDR 0x48
+
+SparkFun_Ambient_Light light(AL_ADDR);
+VEML6030_Lux_Histogram histogram;
+
+// Possible values: .125, .25, 1, 2
+// Both .125 and .25 should be used in most cases except darker rooms.
+// A gain of 2 should only be used if the sensor will be covered by a dark
+// glass.
+float gain = .125;
+
+// Possible integration times in milliseconds: 800, 400, 200, 100, 50, 25
+// Higher times give higher resolutions and should be used in darker light. 
+int integTime = 100;
+
+// Length of a window in milliseconds.
+unsigned long windowLength = 60000;
+unsigned long windowStart = 0;
+
+// Sample count at the last insert, a failed read leaves it where it was.
+uint32_t lastSample = 0;
+
+uint8_t snapshot[3 + (3 * VEML6030_HIST_BINS)];
+
+void setup(){
+
+  Wire.begin();
+  Serial.begin(115200);
+
+  if(light.begin())
+    Serial.println("Ready to sense some light!"); 
+  else
+    Serial.println("Could not communicate with the sensor!");
+
+  light.setGain(gain);
+  light.setIntegTime(integTime);
+
+}
+
+void loop(){
+
+  // The raw count and the settings it was taken under are kept by the
+  // library, so the histogram costs no extra bus traffic. They stay at the
+  // last good reading when a read fails, so only insert new ones.
+  light.readLight();
+  if (light.getSampleCount() != lastSample) {
+    lastSample = light.getSampleCount();
+    histogram.insert(light.getLastRawLight(), light.getLastSettingsTag());
+  }
+
+  if (millis() - windowStart >= windowLength) {
+    Serial.print("Readings: ");
+    Serial.print(histogram.count());
+    Serial.print(" p5: ");
+    Serial.print(histogram.percentile(5));
+    Serial.print(" p50: ");
+    Serial.print(histogram.percentile(50));
+    Serial.print(" p95: ");
+    Serial.print(histogram.percentile(95));
+    Serial.println(" Lux");
+
+    uint16_t len = histogram.serialize(snapshot, sizeof(snapshot));
+    Serial.print("Snapshot (");
+    Serial.print(len);
+    Serial.print(" bytes): ");
+    for (uint16_t i = 0; i < len; i++) {
+      if (snapshot[i] < 0x10)
+        Serial.print("0");
+      Serial.print(snapshot[i], HEX);
+    }
+    Serial.println();
+
+    // Start the next window fresh. Use histogram.rotate(1) instead to keep
+    // half the weight of the old readings for a rolling window.
+    histogram.rotate();
+    windowStart = millis();
+  }
+
+  delay(integTime);
+
+}
@@ -0,0 +1,93 @@
+/*
+  This example code will walk you through how to watch the thresholds of
+  several SparkFun VEML6030 Ambient Light Sensors without wiring up an
+  interrupt pin for each. Thresholds are checked in software against the
+  readings the sketch takes anyway, so unlike polling readInterrupt() on every
+  sensor (Example3) this costs no extra bus traffic. Sensors that do have their
+  INT pin wired are checked with the pin instead. Events from all sensors are
+  handed over together once per pass. 
+  
+  SparkFun Electronics 
+  Date: October 2026
+
+	License: This code is public domain but if you use this and we meet someday, get me a beer! 
+
+	Feel like supporting our work? Buy a board from Sparkfun!
+	https://www.sparkfun.com/products/15436
+
+*/
+
+#include <Wire.h>
+#include "SparkFun_VEML6030_Ambient_Light_Sensor.h"
+#include "SparkFun_VEML6030_Threshold_Engine.h"
+
+// Two sensors on this bus, more can go behind an I2C mux.
+SparkFun_Ambient_Light light1(0x48);
+SparkFun_Ambient_Light light2(0x10);
+
+VEML6030_Threshold_Engine engine;
+
+// Thresholds are in raw counts. At a gain of 1/8 and 100ms each count is
+// 0.4608 lux, so these are about 20 and 400 lux.
+uint16_t lowThresh = 43; 
+uint16_t highThresh = 868; 
+
+// Number of readings in a row that must be below/above a threshold: 1, 2, 4
+// or 8.
+int numbValues = 2;
+
+void handleEvents(const VEML6030_Event *events, uint8_t count){
+
+  for (uint8_t i = 0; i < count; i++) {
+    Serial.print("Sensor ");
+    Serial.print(events[i].sensor);
+    if (events[i].type == INT_HIGH)
+      Serial.print(": High threshold crossed! Raw count: ");
+    else
+      Serial.print(": Low threshold crossed! Raw count: ");
+    Serial.println(events[i].rawLight);
+  }
+
+}
+
+void setup(){
+
+  Wire.begin();
+  Serial.begin(115200);
+  
+  if(light1.begin() && light2.begin())
+    Serial.println("Ready to sense some light!"); 
+  else
+    Serial.println("Could not communicate with the sensors!");
+
+  light1.setGain(.125);
+  light1.setIntegTime(100);
+  light2.setGain(.125);
+  light2.setIntegTime(100);
+
+  // The thresholds are tied to the settings above, change them with
+  // engine.setThresh() after changing the gain or integration time.
+  engine.addSensor(light1, lowThresh, highThresh, numbValues);
+  engine.addSensor(light2, lowThresh, highThresh, numbValues);
+  engine.onEvents(handleEvents);
+
+}
+
+void loop(){
+
+  // The sketch's own reads, the engine works off of these. Only the last
+  // reading of each sensor is checked, so read each once per update().
+  long luxVal1 = light1.readLight();
+  long luxVal2 = light2.readLight();
+
+  Serial.print("Ambient Light Readings: ");
+  Serial.print(luxVal1);
+  Serial.print(" ");
+  Serial.print(luxVal2);
+  Serial.println(" Lux");  
+
+  engine.update();
+    
+  delay(200);
+
+}
@@ -0,0 +1,34 @@
+/*
+  Just enough of the Arduino core to build the library on a Linux host for
+  the benchmark. Time only moves when the library calls delay(), so waits
+  in the library don't show up in the host timings.
+*/
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+typedef bool boolean;
+
+#define LOW          0x0
+#define HIGH         0x1
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define SDA 21
+#define SCL 22
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+#endif
@@ -0,0 +1,37 @@
+/*
+  TwoWire for the host benchmark, with a simulated VEML6030 at 0x48 or 0x10
+  on the other end. See sim_veml6030.cpp.
+*/
+
+#ifndef _HOST_WIRE_H_
+#define _HOST_WIRE_H_
+
+#include "Arduino.h"
+
+class TwoWire
+{
+  public:
+
+    void begin();
+    void end();
+    void setClock(uint32_t clock);
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity);
+    int available();
+    int read();
+
+  private:
+
+    uint8_t _address;
+    uint8_t _txBuf[4];
+    uint8_t _txLen;
+    uint8_t _rxBuf[2];
+    uint8_t _rxLen;
+    uint8_t _rxPos;
+};
+
+extern TwoWire Wire;
+
+#endif
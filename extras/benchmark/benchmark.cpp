@@ -0,0 +1,215 @@
+/*
+  Host version of Example7_Benchmark. It builds the library against a
+  simulated VEML6030 and times every public function on the host CPU, so the
+  cost of the library's own code can be compared between versions without a
+  board. The bus traffic counts and modeled bus times match what the sketch
+  reports on a real board, the sketch stays the way to cross-check the
+  timings on the device itself.
+
+  Every gain and integration time is run at four light levels, since the
+  conversion to lux and the compensation above 1000 lux cost more the
+  brighter it gets: low and mid are below 1000 lux, bright is above it and
+  saturated is a full count. Where a level is past a setting's range the
+  count is capped at full, like the sensor does.
+
+  Usage: benchmark [results file], results go to bench_results.csv by
+  default. See the Makefile to build it with and without VEML6030_NO_FLOAT.
+*/
+
+#include <stdio.h>
+#include <chrono>
+#include "SparkFun_VEML6030_Ambient_Light_Sensor.h"
+#include "sim_veml6030.h"
+
+#define AL_ADDR 0x48
+
+// How often each function is called, the results are per call. Much more
+// than the sketch since the host timer and cache need the repetition.
+#define RUNS 10000
+
+#define DEFAULT_RESULTS "bench_results.csv"
+
+// Light levels in lux, 0 for a full count.
+#define LEVEL_COUNT 4
+const char *levelNames[] = {"low", "mid", "bright", "saturated"};
+uint32_t levelLux[] = {10, 500, 5000, 0};
+
+SparkFun_Ambient_Light light(AL_ADDR);
+
+// Only used to time setLock(), a lock once set can't be taken off again.
+SparkFun_Ambient_Light lockTest(AL_ADDR);
+VEML6030_NoLock noLock;
+
+VEML6030_GAIN gains[] = {VEML6030_GAIN_1_8, VEML6030_GAIN_1_4, VEML6030_GAIN_1, VEML6030_GAIN_2};
+const char *gainNames[] = {"0.125", "0.25", "1", "2"};
+int times[] = {25, 50, 100, 200, 400, 800};
+
+FILE *results;
+bool warmingUp;
+VEML6030_GAIN gain;
+const char *gainName;
+int integTime;
+const char *levelName;
+uint16_t raw;
+uint32_t rawLux;
+
+// Some calls return values nothing else looks at, keep the compiler from
+// dropping them.
+volatile uint32_t sink;
+
+// Prints a total over all runs as the value per call, with one decimal.
+void printPerCall(uint64_t total){
+
+  uint64_t tenths = (total * 10) / RUNS;
+  fprintf(results, "%llu.%llu", (unsigned long long)(tenths / 10), (unsigned long long)(tenths % 10));
+
+}
+
+// Modeled time in microseconds for the bus traffic of all runs.
+uint64_t busTime(uint32_t clock){
+
+  uint64_t bits = (static_cast<uint64_t>(light.getBusBytes()) * 9) + (static_cast<uint64_t>(light.getBusTransactions()) * 2);
+  return (bits * 1000000) / clock;
+
+}
+
+void report(const char *name, uint64_t elapsedNs){
+
+  if (warmingUp)
+    return;
+
+  fprintf(results, "%s,%s,%d,%s,%u,", name, gainName, integTime, levelName, raw);
+  printPerCall(light.getBusTransactions());
+  fprintf(results, ",");
+  printPerCall(light.getBusBytes());
+  fprintf(results, ",");
+  printPerCall(busTime(100000));
+  fprintf(results, ",");
+  printPerCall(busTime(400000));
+  fprintf(results, ",");
+  printPerCall(busTime(1000000));
+  fprintf(results, ",");
+  printPerCall(elapsedNs);
+  fprintf(results, "\n");
+
+}
+
+// Calls the given code RUNS times and reports on it.
+#define BENCH(name, call) {                                                \
+  light.resetBusStats();                                                   \
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now(); \
+  for (uint32_t run = 0; run < RUNS; run++) { call; }                      \
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();   \
+  report(name, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()); \
+}
+
+// Sets up the simulated sensor for one gain, integration time and light
+// level.
+void setCell(uint8_t g, uint8_t t, uint8_t l){
+
+  gain = gains[g];
+  gainName = gainNames[g];
+  integTime = times[t];
+  levelName = levelNames[l];
+  light.setGain(gain);
+  light.setIntegTime(integTime);
+
+  // Resolution is in 0.1 milli-lux.
+  uint16_t res = SparkFun_Ambient_Light::luxResolution(light.getSettingsTag());
+  uint32_t count = (levelLux[l] == 0) ? 0xFFFF : (levelLux[l] * 10000) / res;
+  raw = (count > 0xFFFF) ? 0xFFFF : count;
+  rawLux = (static_cast<uint32_t>(raw) * res) / 10000;
+  simSetLight(raw, raw);
+
+}
+
+// Times every public function once under the current cell.
+void runCell(){
+
+  BENCH("begin", sink = light.begin());
+  BENCH("setGain", light.setGain(gain));
+  BENCH("readGain", sink = light.readGain());
+  BENCH("setIntegTime", light.setIntegTime(integTime));
+  BENCH("readIntegTime", sink = light.readIntegTime());
+  BENCH("setProtect", light.setProtect(1));
+  BENCH("readProtect", sink = light.readProtect());
+  BENCH("enableInt", light.enableInt());
+  BENCH("disableInt", light.disableInt());
+  BENCH("readIntSetting", sink = light.readIntSetting());
+  BENCH("shutDown", light.shutDown());
+  BENCH("powerOn", light.powerOn());
+  BENCH("enablePowSave", light.enablePowSave());
+  BENCH("disablePowSave", light.disablePowSave());
+  BENCH("readPowSavEnabled", sink = light.readPowSavEnabled());
+  BENCH("setPowSavMode", light.setPowSavMode(1));
+  BENCH("readPowSavMode", sink = light.readPowSavMode());
+  BENCH("readInterrupt", sink = light.readInterrupt());
+  BENCH("setIntLowThresh", light.setIntLowThresh(20));
+  BENCH("readLowThresh", sink = light.readLowThresh());
+  BENCH("setIntHighThresh", light.setIntHighThresh(400));
+  BENCH("readHighThresh", sink = light.readHighThresh());
+  BENCH("readLight", sink = light.readLight());
+  BENCH("readWhiteLight", sink = light.readWhiteLight());
+  BENCH("readLightMilli", sink = light.readLightMilli());
+  BENCH("readWhiteLightMilli", sink = light.readWhiteLightMilli());
+  BENCH("enableBusRecovery", light.enableBusRecovery());
+  BENCH("disableBusRecovery", light.disableBusRecovery());
+  BENCH("recover", sink = light.recover());
+  BENCH("isHealthy", sink = light.isHealthy());
+  BENCH("getFailCount", sink = light.getFailCount());
+  BENCH("getRecoveryCount", sink = light.getRecoveryCount());
+  BENCH("getRecoveryTime", sink = light.getRecoveryTime());
+  BENCH("setLock", lockTest.setLock(noLock));
+  BENCH("readConfig", VEML6030_Config config; light.readConfig(config); sink = config.setting);
+  BENCH("getLockContention", sink = light.getLockContention());
+  BENCH("getLockWaitTime", sink = light.getLockWaitTime());
+  BENCH("getBusTransactions", sink = light.getBusTransactions());
+  BENCH("getBusBytes", sink = light.getBusBytes());
+  BENCH("resetBusStats", light.resetBusStats());
+  BENCH("getLastRawLight", sink = light.getLastRawLight());
+  BENCH("getLastSettingsTag", sink = light.getLastSettingsTag());
+  BENCH("getSettingsTag", sink = light.getSettingsTag());
+  BENCH("getSampleCount", sink = light.getSampleCount());
+  BENCH("luxResolution", sink = SparkFun_Ambient_Light::luxResolution(light.getLastSettingsTag()));
+  BENCH("compensateLux", sink = SparkFun_Ambient_Light::compensateLux(rawLux));
+
+}
+
+int main(int argc, char *argv[]){
+
+  const char *path = (argc > 1) ? argv[1] : DEFAULT_RESULTS;
+  results = fopen(path, "w");
+  if (results == NULL) {
+    fprintf(stderr, "Could not open %s\n", path);
+    return 1;
+  }
+
+  Wire.begin();
+  if (!light.begin() || !lockTest.begin()) {
+    fprintf(stderr, "Could not communicate with the simulated sensor!\n");
+    return 1;
+  }
+
+  // One pass that isn't reported, so that the first cell isn't paying for
+  // a cold cache.
+  warmingUp = true;
+  setCell(0, 0, LEVEL_COUNT - 1);
+  runCell();
+  warmingUp = false;
+
+  fprintf(results, "method,gain,integ_time,light,raw,transactions,bytes,bus_us_100k,bus_us_400k,bus_us_1m,host_ns\n");
+
+  for (uint8_t g = 0; g < 4; g++) {
+    for (uint8_t t = 0; t < 6; t++) {
+      for (uint8_t l = 0; l < LEVEL_COUNT; l++) {
+        setCell(g, t, l);
+        runCell();
+      }
+    }
+  }
+
+  fclose(results);
+  printf("Results written to %s\n", path);
+  return 0;
+
+}
@@ -0,0 +1,14 @@
+/*
+  Controls of the simulated VEML6030 in sim_veml6030.cpp.
+*/
+
+#ifndef _SIM_VEML6030_H_
+#define _SIM_VEML6030_H_
+
+#include <stdint.h>
+
+// This function sets the raw counts the sensor reads back from its ambient
+// light (0x04) and white light (0x05) registers.
+void simSetLight(uint16_t als, uint16_t white);
+
+#endif
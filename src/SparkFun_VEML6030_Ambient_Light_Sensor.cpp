@@ -10,7 +10,40 @@
 
 #include "SparkFun_VEML6030_Ambient_Light_Sensor.h"
 
-SparkFun_Ambient_Light::SparkFun_Ambient_Light(uint8_t address){  _address = address; } //Constructor for I2C
+SparkFun_Ambient_Light::SparkFun_Ambient_Light(uint8_t address) //Constructor for I2C
+{
+
+  _address = address;
+
+  // Power on defaults from the datasheet, the sensor starts shut down.
+  _shadow[SETTING_REG] = SHUTDOWN;
+  _shadow[H_THRESH_REG] = 0x0000;
+  _shadow[L_THRESH_REG] = 0x0000;
+  _shadow[POWER_SAVE_REG] = 0x0000;
+  _configSeq = 0;
+
+  _lock = NULL;
+  _lockContention = 0;
+  _lockWaitTime = 0;
+
+  _busTransactions = 0;
+  _busBytes = 0;
+
+  _lastRaw = 0;
+  _lastTag = _settingsTag(_shadow[SETTING_REG]);
+  _sampleCount = 0;
+
+  _recoveryEnabled = false;
+  _sdaPin = VEML6030_NO_PIN;
+  _sclPin = VEML6030_NO_PIN;
+  _busClock = 0;
+  _failCount = 0;
+  _recoveryCount = 0;
+  _recoveryTime = 0;
+  _lastRecovery = 0;
+  _backoff = VEML6030_BACKOFF_MIN;
+
+}
 
 bool SparkFun_Ambient_Light::begin( TwoWire &wirePort )
 {
@@ -20,12 +53,29 @@ bool SparkFun_Ambient_Light::begin( TwoWire &wirePort )
   // Device is powered down by default. 
   powerOn(); 
 
+  _lockBus();
+
   _i2cPort->beginTransmission(_address);
   uint8_t _ret = _i2cPort->endTransmission();
-  if( !_ret )
-    return true; 
-  else 
+  _busTransactions++;
+  _busBytes++; // Address only.
+  if( _ret ) {
+    _unlockBus();
     return false; 
+  }
+
+  // Keep a local copy of the configuration registers so that they can be
+  // restored after a bus recovery.
+  uint16_t _regVal;
+  for (uint8_t _reg = SETTING_REG; _reg <= POWER_SAVE_REG; _reg++) {
+    if (_busRead(_reg, _regVal))
+      _setShadow(_reg, _regVal);
+  }
+
+  _failCount = 0;
+  _backoff = VEML6030_BACKOFF_MIN;
+  _unlockBus();
+  return true; 
 
 }
 
@@ -34,6 +84,7 @@ bool SparkFun_Ambient_Light::begin( TwoWire &wirePort )
 // are 1/8, 1/4, 1, and 2. The highest setting should only be used if the
 // sensors is behind dark glass, where as the lowest setting should be used in
 // dark rooms. The datasheet suggests always leaving it at around 1/4 or 1/8.
+#ifndef VEML6030_NO_FLOAT
 void SparkFun_Ambient_Light::setGain(float gainVal){
 
   uint16_t bits; 
@@ -51,6 +102,18 @@ void SparkFun_Ambient_Light::setGain(float gainVal){
   
   _writeRegister(SETTING_REG, GAIN_MASK, bits, GAIN_POS); 
 
+}
+#endif
+
+// REG0x00, bits [12:11]
+// Same as above, taking one of the VEML6030_GAIN values. 
+void SparkFun_Ambient_Light::setGain(VEML6030_GAIN gainVal){
+
+  if (gainVal > VEML6030_GAIN_1_4)
+    return;
+
+  _writeRegister(SETTING_REG, GAIN_MASK, gainVal, GAIN_POS); 
+
 }
 
 // REG0x00, bits [12:11]
@@ -58,24 +121,24 @@ void SparkFun_Ambient_Light::setGain(float gainVal){
 // are 1/8, 1/4, 1, and 2. The highest setting should only be used if the
 // sensors is behind dark glass, where as the lowest setting should be used in
 // dark rooms. The datasheet suggests always leaving it at around 1/4 or 1/8.
+// Without floating point it returns one of the VEML6030_GAIN values. 
+#ifndef VEML6030_NO_FLOAT
 float SparkFun_Ambient_Light::readGain(){
  
+  uint16_t regVal = _readRegister(SETTING_REG); // Get register
+  return _decodeGain(regVal);
+  
+}
+#else
+VEML6030_GAIN SparkFun_Ambient_Light::readGain(){
+ 
   uint16_t regVal = _readRegister(SETTING_REG); // Get register
   regVal &= (~GAIN_MASK); // Invert the gain mask to _keep_ the gain
   regVal = (regVal >> GAIN_POS); // Move values to front of the line. 
-   
-  if (regVal == 0)
-    return 1;
-  else if (regVal == 1)
-    return 2;
-  else if (regVal == 2)
-    return .125;
-  else if (regVal == 3)
-    return .25;
-  else   
-    return UNKNOWN_ERROR; 
+  return static_cast<VEML6030_GAIN>(regVal);
   
 }
+#endif
 
 // REG0x00, bits[9:6]
 // This function sets the integration time (the saturation time of light on the
@@ -112,23 +175,7 @@ void SparkFun_Ambient_Light::setIntegTime(uint16_t time){
 uint16_t SparkFun_Ambient_Light::readIntegTime(){
 
   uint16_t regVal = _readRegister(SETTING_REG); 
-  regVal &= (~INTEG_MASK); 
-  regVal = (regVal >> INTEG_POS); 
-
-  if (regVal == 0)
-    return 100;
-  else if (regVal == 1)
-    return 200;
-  else if (regVal == 2)
-    return 400;
-  else if (regVal == 3)
-    return 800;
-  else if (regVal == 8)
-    return 50;
-  else if (regVal == 12)
-    return 25;
-  else   
-    return UNKNOWN_ERROR; 
+  return _decodeIntegTime(regVal);
 
 }
 
@@ -328,8 +375,7 @@ void SparkFun_Ambient_Light::setIntLowThresh(uint32_t luxVal){
   if (luxVal < 0 || luxVal > 120000)
     return;
   
-  uint16_t luxBits = _calculateBits(luxVal); 
-  _writeRegister(L_THRESH_REG, THRESH_MASK, luxBits, NO_SHIFT);
+  _writeThresh(L_THRESH_REG, luxVal);
 
 }
 
@@ -337,9 +383,7 @@ void SparkFun_Ambient_Light::setIntLowThresh(uint32_t luxVal){
 // This function reads the lower limit for the Ambient Light Sensor's interrupt. 
 uint32_t SparkFun_Ambient_Light::readLowThresh(){
 
-  uint16_t threshVal = _readRegister(L_THRESH_REG);
-  uint32_t threshLux = _calculateLux(threshVal); 
-  return threshLux; 
+  return _readThresh(L_THRESH_REG); 
 
 }
 
@@ -351,8 +395,7 @@ void SparkFun_Ambient_Light::setIntHighThresh(uint32_t luxVal){
   if (luxVal < 0 || luxVal > 120000)
     return;
 
-  uint16_t luxBits = _calculateBits(luxVal); 
-  _writeRegister(H_THRESH_REG, THRESH_MASK, luxBits, NO_SHIFT);
+  _writeThresh(H_THRESH_REG, luxVal);
 
 }
 
@@ -360,9 +403,7 @@ void SparkFun_Ambient_Light::setIntHighThresh(uint32_t luxVal){
 // This function reads the upper limit for the Ambient Light Sensor's interrupt. 
 uint32_t SparkFun_Ambient_Light::readHighThresh(){
 
-  uint16_t threshVal = _readRegister(H_THRESH_REG);
-  uint32_t threshLux = _calculateLux(threshVal); 
-  return threshLux; 
+  return _readThresh(H_THRESH_REG); 
 
 }
 
@@ -372,15 +413,7 @@ uint32_t SparkFun_Ambient_Light::readHighThresh(){
 // value exceeds 1000 then a compensation formula is applied to it. 
 uint32_t SparkFun_Ambient_Light::readLight(){
 
-  uint16_t lightBits =  _readRegister(AMBIENT_LIGHT_DATA_REG); 
-  uint32_t luxVal = _calculateLux(lightBits); 
-
-  if (luxVal > 1000) {
-    uint32_t compLux = _luxCompensation(luxVal); 
-    return compLux; 
-  }
-  else
-    return luxVal;
+  return _readLux(AMBIENT_LIGHT_DATA_REG);
 
 }
 
@@ -390,30 +423,382 @@ uint32_t SparkFun_Ambient_Light::readLight(){
 // value exceeds 1000 then a compensation formula is applied to it. 
 uint32_t SparkFun_Ambient_Light::readWhiteLight(){
 
-  uint16_t lightBits = _readRegister(WHITE_LIGHT_DATA_REG); 
-  uint32_t luxVal = _calculateLux(lightBits); 
+  return _readLux(WHITE_LIGHT_DATA_REG);
+
+}
+
+// REG[0x04], bits[15:0]
+// Same as readLight() but in milli-lux, with the conversion and
+// compensation done in integer math. Compensated values too large for
+// milli-lux (from around 50,000 lux) are capped at 0xFFFFFFFF. 
+uint32_t SparkFun_Ambient_Light::readLightMilli(){
+
+  return _readMilliLux(AMBIENT_LIGHT_DATA_REG);
+
+}
+
+// REG[0x05], bits[15:0]
+// Same as readWhiteLight() but in milli-lux, with the conversion and
+// compensation done in integer math. Capped the same as above. 
+uint32_t SparkFun_Ambient_Light::readWhiteLightMilli(){
+
+  return _readMilliLux(WHITE_LIGHT_DATA_REG);
+
+}
+
+// This function enables the bus health monitor's recovery. Once the sensor
+// fails VEML6030_FAIL_LIMIT transactions in a row, SCL is clocked until the
+// sensor lets go of SDA and the sensor is re-initialized with its last known
+// configuration (gain, integration time, thresholds and power save mode).
+// The SDA and SCL pins are optional, without them only the re-init is done. 
+// Clearing the bus restarts the I2C port, which resets its clock on most
+// cores, so pass the clock set with setClock() to have it set again. 
+void SparkFun_Ambient_Light::enableBusRecovery(uint8_t sdaPin, uint8_t sclPin,
+                                               uint32_t busClock){
+
+  _sdaPin = sdaPin;
+  _sclPin = sclPin;
+  _busClock = busClock;
+  _recoveryEnabled = true;
+
+}
+
+// This function disables the bus health monitor's recovery. Failures are
+// still counted. 
+void SparkFun_Ambient_Light::disableBusRecovery(){
+
+  _recoveryEnabled = false;
+
+}
+
+// This function clears the bus and re-initializes the sensor right away,
+// regardless of the backoff. Returns true if the sensor answered. 
+bool SparkFun_Ambient_Light::recover(){
+
+  _lockBus();
+  bool _ok = _recover();
+  _unlockBus();
+  return _ok;
 
-  if (luxVal > 1000) {
-    uint32_t compLux = _luxCompensation(luxVal); 
-    return compLux; 
+}
+
+// This function checks if the sensor has failed fewer than
+// VEML6030_FAIL_LIMIT transactions in a row. 
+bool SparkFun_Ambient_Light::isHealthy(){
+
+  return (_failCount < VEML6030_FAIL_LIMIT);
+
+}
+
+// This function returns the number of consecutive failed transactions. 
+uint8_t SparkFun_Ambient_Light::getFailCount(){
+
+  return _failCount;
+
+}
+
+// This function returns the number of recoveries attempted so far. 
+uint16_t SparkFun_Ambient_Light::getRecoveryCount(){
+
+  return _recoveryCount;
+
+}
+
+// This function returns the total time spent recovering in microseconds. 
+uint32_t SparkFun_Ambient_Light::getRecoveryTime(){
+
+  return _recoveryTime;
+
+}
+
+// This function sets the lock that is taken around every sequence of bus
+// transactions, needed when several tasks or cores use the sensor. Sensors
+// on the same I2C port should share one lock. 
+void SparkFun_Ambient_Light::setLock(VEML6030_Lock &lock){
+
+  _lock = &lock;
+
+}
+
+// This function copies the sensor's configuration as last written by the
+// library. It doesn't touch the bus, and never returns a half updated
+// configuration. It only waits for the lock if a write keeps getting in
+// the way VEML6030_SNAPSHOT_TRIES times, for example because the caller
+// preempted the task that was writing. Don't call it from an interrupt. 
+void SparkFun_Ambient_Light::readConfig(VEML6030_Config &config){
+
+  uint16_t _seq;
+
+  // Try again if a write was in progress or happened while copying.
+  for (uint8_t _try = 0; _try < VEML6030_SNAPSHOT_TRIES; _try++) {
+    _seq = _configSeq;
+    VEML6030_BARRIER();
+    _copyShadow(config);
+    VEML6030_BARRIER();
+    if (!(_seq & 1) && (_seq == _configSeq))
+      return;
+#ifdef VEML6030_HAS_RTOS
+    taskYIELD();
+#endif
   }
+
+  // Spinning any longer could starve a writer this task preempted. Writers
+  // only run under the bus lock, so wait for it instead; a FreeRTOS mutex
+  // also lends the writer this task's priority while doing so.
+  _lockBus();
+  _copyShadow(config);
+  _unlockBus();
+
+}
+
+// This function returns how many times the lock was already taken when
+// the sensor needed it. 
+uint32_t SparkFun_Ambient_Light::getLockContention(){
+
+  return _lockContention;
+
+}
+
+// This function returns the total time spent waiting for the lock in
+// microseconds. 
+uint32_t SparkFun_Ambient_Light::getLockWaitTime(){
+
+  return _lockWaitTime;
+
+}
+
+// This function returns the number of I2C transactions (every start
+// condition, repeated or not) since the last resetBusStats(). Reading a
+// register takes two, writing one takes one. 
+uint32_t SparkFun_Ambient_Light::getBusTransactions(){
+
+  return _busTransactions;
+
+}
+
+// This function returns the number of bytes put on the bus, address bytes
+// included, since the last resetBusStats(). 
+uint32_t SparkFun_Ambient_Light::getBusBytes(){
+
+  return _busBytes;
+
+}
+
+// This function clears the transaction and byte counts. 
+void SparkFun_Ambient_Light::resetBusStats(){
+
+  _busTransactions = 0;
+  _busBytes = 0;
+
+}
+
+// This function returns the raw count of the last successful readLight(),
+// without touching the bus. 
+uint16_t SparkFun_Ambient_Light::getLastRawLight(){
+
+  return _lastRaw;
+
+}
+
+// This function returns the settings tag the last successful readLight()
+// was taken under: the gain bits in [5:4] and the integration time bits in
+// [3:0]. Together with the raw count it pins down the lux value. 
+uint8_t SparkFun_Ambient_Light::getLastSettingsTag(){
+
+  return _lastTag;
+
+}
+
+// This function returns the settings tag the sensor is set to now, as last
+// written by the library, without touching the bus. 
+uint8_t SparkFun_Ambient_Light::getSettingsTag(){
+
+  VEML6030_Config _config;
+  readConfig(_config);
+  return _settingsTag(_config.setting);
+
+}
+
+// This function returns the number of successful readLight() calls, so
+// that new samples can be told apart from ones already seen. 
+uint32_t SparkFun_Ambient_Light::getSampleCount(){
+
+  return _sampleCount;
+
+}
+
+// This function returns the lux per count for a settings tag, in units of
+// 0.1 milli-lux, or 0 for an invalid tag. Same values as the tables above. 
+uint16_t SparkFun_Ambient_Light::luxResolution(uint8_t settingsTag){
+
+  // The finest resolution is 0.0036 lux at a gain of 2 and 800ms, every
+  // step down in gain or integration time doubles it. These are the number of
+  // doublings indexed by the register's bits.
+  static const uint8_t _gainShift[] = {1, 0, 4, 3}; // 1, 2, 1/8, 1/4
+  uint8_t _gainBits = (settingsTag >> 4) & 0x03;
+  uint8_t _integBits = settingsTag & 0x0F;
+  uint8_t _integShift;
+
+  if (_integBits == 0) // 100ms
+    _integShift = 3;
+  else if (_integBits == 1) // 200ms
+    _integShift = 2;
+  else if (_integBits == 2) // 400ms
+    _integShift = 1;
+  else if (_integBits == 3) // 800ms
+    _integShift = 0;
+  else if (_integBits == 8) // 50ms
+    _integShift = 4;
+  else if (_integBits == 12) // 25ms
+    _integShift = 5;
+  else
+    return 0;
+
+  return (36 << (_gainShift[_gainBits] + _integShift));
+
+}
+
+// This function applies the datasheet's compensation for readings over
+// 1000 lux to a lux value, the same way readLight() does. Values past the
+// sensor's highest reading are treated as that reading. 
+uint32_t SparkFun_Ambient_Light::compensateLux(uint32_t luxVal){
+
+  if (luxVal > 1000)
+    return _luxCompensation(luxVal);
   else
     return luxVal;
 
 }
 
+// This function reads one of the light data registers and converts it to
+// lux with the settings it was taken under. 
+uint32_t SparkFun_Ambient_Light::_readLux(uint8_t _reg){
+
+  uint16_t setting;
+  uint16_t lightBits = _readLightBits(_reg, setting); 
+  uint32_t luxVal = _calculateLux(lightBits, setting); 
+
+  return compensateLux(luxVal);
+
+}
+
+// Same as above but in milli-lux, in integer math. 
+uint32_t SparkFun_Ambient_Light::_readMilliLux(uint8_t _reg){
+
+  uint16_t setting;
+  uint16_t lightBits = _readLightBits(_reg, setting); 
+  uint32_t milliLux = _calculateMilliLux(lightBits, setting); 
+
+  // Same cut off as readLight(), which compensates above 1000 whole lux.
+  if (milliLux / 1000 <= 1000)
+    return milliLux;
+
+  uint64_t compMilliLux = _milliLuxCompensation(milliLux); 
+  if (compMilliLux > 0xFFFFFFFF)
+    return 0xFFFFFFFF;
+  else
+    return compMilliLux;
+
+}
+
+// This function reads one of the light data registers, keeping the sample
+// when it is the ambient light, and hands back the settings it was taken
+// under. 
+uint16_t SparkFun_Ambient_Light::_readLightBits(uint8_t _reg, uint16_t &_setting){
+
+  // The settings only change under the lock, so hold it until both the
+  // reading and the settings that go with it are in hand.
+  uint16_t lightBits; 
+  _lockBus();
+  _setting = _shadow[SETTING_REG];
+  if (!_busRead(_reg, lightBits))
+    lightBits = 0xFFFF;
+  else if (_reg == AMBIENT_LIGHT_DATA_REG) {
+    _lastRaw = lightBits;
+    _lastTag = _settingsTag(_setting);
+    _sampleCount++;
+  }
+  _unlockBus();
+
+  return lightBits;
+
+}
+
+// This function reads one of the threshold registers and converts it to
+// lux with the current settings. 
+uint32_t SparkFun_Ambient_Light::_readThresh(uint8_t _reg){
+
+  uint16_t threshVal;
+  _lockBus();
+  if (!_busRead(_reg, threshVal))
+    threshVal = 0xFFFF;
+  uint16_t setting = _shadow[SETTING_REG];
+  _unlockBus();
+
+  uint32_t threshLux = _calculateLux(threshVal, setting); 
+  return threshLux; 
+
+}
+
+// This function converts a lux value to bits with the current settings
+// and writes it to one of the threshold registers. 
+void SparkFun_Ambient_Light::_writeThresh(uint8_t _reg, uint32_t _luxVal){
+
+  _lockBus();
+  uint16_t luxBits = _calculateBits(_luxVal, _shadow[SETTING_REG]); 
+  _modifyRegister(_reg, THRESH_MASK, luxBits, NO_SHIFT);
+  _unlockBus();
+
+}
+
 // This function compensates for lux values over 1000. From datasheet:
 // "Illumination values higher than 1000 lx show non-linearity. This
 // non-linearity is the same for all sensors, so a compensation forumla..."
 // etc. etc. 
 uint32_t SparkFun_Ambient_Light::_luxCompensation(uint32_t _luxVal){ 
 
+  // Past the sensor's highest reading the result would no longer fit 32 bits.
+  if (_luxVal > VEML6030_MAX_MILLI_LUX / 1000)
+    _luxVal = VEML6030_MAX_MILLI_LUX / 1000;
+
+#ifndef VEML6030_NO_FLOAT
   // Polynomial is pulled from pg 10 of the datasheet. 
   uint32_t _compLux = (.00000000000060135 * (pow(_luxVal, 4))) - 
                       (.0000000093924 * (pow(_luxVal, 3))) + 
                       (.000081488 * (pow(_luxVal,2))) + 
                       (1.0023 * _luxVal);
   return _compLux;
+#else
+  return (_milliLuxCompensation(_luxVal * 1000) / 1000);
+#endif
+
+}
+
+// Same as above in milli-lux, in integer math. Values past the sensor's
+// highest reading are treated as that reading. Past roughly 50,000 lux
+// the result no longer fits 32 bits. 
+uint64_t SparkFun_Ambient_Light::_milliLuxCompensation(uint32_t _milliLux){ 
+
+  // The x^4 term below overflows 64 bits a little past the sensor's range.
+  if (_milliLux > VEML6030_MAX_MILLI_LUX)
+    _milliLux = VEML6030_MAX_MILLI_LUX;
+
+  // The same polynomial with its coefficients scaled to milli-lux and to
+  // powers of two, so that it only takes multiplies and shifts. The higher
+  // terms work on whole lux, like the floating point version.
+  //   1.0023 x               -> x + 23x / 10000
+  //   8.1488e-5 x^2 * 1000   -> x^2 * 85446 >> 20
+  //   9.3924e-9 x^3 * 1000   -> (x^3 >> 16) * 645441 >> 20
+  //   6.0135e-13 x^4 * 1000  -> (x^2 >> 10)^2 * 84632 >> 27
+  uint64_t _lux = _milliLux / 1000;
+  uint64_t _luxSq = _lux * _lux;
+  uint64_t _luxSqShift = _luxSq >> 10;
+
+  uint64_t _compLux = _milliLux + ((_milliLux * 23) / 10000);
+  _compLux += (_luxSq * 85446) >> 20;
+  _compLux += (_luxSqShift * _luxSqShift * 84632) >> 27;
+  _compLux -= (((_luxSq * _lux) >> 16) * 645441) >> 20;
+  return _compLux;
 
 }
 
@@ -422,13 +807,21 @@ uint32_t SparkFun_Ambient_Light::_luxCompensation(uint32_t _luxVal){
 // to use by using the bit representation of the gain as an index to look up
 // the conversion value in the correct integration time array. It then converts 
 // the value and returns it.  
-uint32_t SparkFun_Ambient_Light::_calculateLux(uint16_t _lightBits){
+uint32_t SparkFun_Ambient_Light::_calculateLux(uint16_t _lightBits, uint16_t _setting){
+
+#ifdef VEML6030_NO_FLOAT
+  uint16_t _res = luxResolution(_settingsTag(_setting));
+  if (_res == 0)
+    return UNKNOWN_ERROR;
 
+  // Resolution is in 0.1 milli-lux.
+  return ((static_cast<uint32_t>(_lightBits) * _res) / 10000);
+#else
   float _luxConv; 
   uint8_t _convPos;  
 
-  float _gain = readGain(); 
-  uint16_t _integTime = readIntegTime();
+  float _gain = _decodeGain(_setting); 
+  uint16_t _integTime = _decodeIntegTime(_setting);
 
   // Here the gain is checked to get the position of the conversion value
   // within the integration time arrays. These values also represent the bit
@@ -465,6 +858,19 @@ uint32_t SparkFun_Ambient_Light::_calculateLux(uint16_t _lightBits){
   // it. 
   uint32_t _calculatedLux = (_luxConv * _lightBits);
   return _calculatedLux;
+#endif
+
+}
+
+// Same as above but in milli-lux, in integer math. 
+uint32_t SparkFun_Ambient_Light::_calculateMilliLux(uint16_t _lightBits, uint16_t _setting){
+
+  uint16_t _res = luxResolution(_settingsTag(_setting));
+  if (_res == 0)
+    return UNKNOWN_ERROR;
+
+  // Resolution is in 0.1 milli-lux.
+  return ((static_cast<uint32_t>(_lightBits) * _res) / 10);
 
 }
 
@@ -474,13 +880,25 @@ uint32_t SparkFun_Ambient_Light::_calculateLux(uint16_t _lightBits){
 // intergration time settings. As a result the lux value needs to be
 // calculated with the current settings and this function accomplishes
 // that.  
-uint16_t SparkFun_Ambient_Light::_calculateBits(uint32_t _luxVal){
+uint16_t SparkFun_Ambient_Light::_calculateBits(uint32_t _luxVal, uint16_t _setting){
+
+#ifdef VEML6030_NO_FLOAT
+  uint16_t _res = luxResolution(_settingsTag(_setting));
+  if (_res == 0)
+    return UNKNOWN_ERROR;
 
+  // Resolution is in 0.1 milli-lux, the lux value is at most 120000 so this
+  // fits. Anything past the register's range is capped.
+  uint32_t _calculatedBits = (_luxVal * 10000) / _res;
+  if (_calculatedBits > 0xFFFF)
+    return 0xFFFF;
+  return _calculatedBits;
+#else
   float _luxConv; 
   uint8_t _convPos;  
 
-  float _gain = readGain();
-  float _integTime = readIntegTime();
+  float _gain = _decodeGain(_setting);
+  float _integTime = _decodeIntegTime(_setting);
   // Here the gain is checked to get the position of the conversion value
   // within the integration time arrays. These values also represent the bit
   // values for setting the gain. 
@@ -516,6 +934,61 @@ uint16_t SparkFun_Ambient_Light::_calculateBits(uint32_t _luxVal){
   // it. 
   uint16_t _calculatedBits = (_luxVal/_luxConv);
   return _calculatedBits;
+#endif
+
+}
+
+// These functions take the gain and integration time out of a value of the
+// settings register. 
+#ifndef VEML6030_NO_FLOAT
+float SparkFun_Ambient_Light::_decodeGain(uint16_t _setting){
+
+  _setting &= (~GAIN_MASK); // Invert the gain mask to _keep_ the gain
+  _setting = (_setting >> GAIN_POS); // Move values to front of the line. 
+   
+  if (_setting == 0)
+    return 1;
+  else if (_setting == 1)
+    return 2;
+  else if (_setting == 2)
+    return .125;
+  else if (_setting == 3)
+    return .25;
+  else   
+    return UNKNOWN_ERROR; 
+
+}
+#endif
+
+uint16_t SparkFun_Ambient_Light::_decodeIntegTime(uint16_t _setting){
+
+  _setting &= (~INTEG_MASK); 
+  _setting = (_setting >> INTEG_POS); 
+
+  if (_setting == 0)
+    return 100;
+  else if (_setting == 1)
+    return 200;
+  else if (_setting == 2)
+    return 400;
+  else if (_setting == 3)
+    return 800;
+  else if (_setting == 8)
+    return 50;
+  else if (_setting == 12)
+    return 25;
+  else   
+    return UNKNOWN_ERROR; 
+
+}
+
+// This function packs the gain and integration time bits of a value of the
+// settings register into a settings tag. 
+uint8_t SparkFun_Ambient_Light::_settingsTag(uint16_t _setting){
+
+  uint8_t _gainBits = (_setting & ~GAIN_MASK) >> GAIN_POS;
+  uint8_t _integBits = (_setting & ~INTEG_MASK) >> INTEG_POS;
+  return ((_gainBits << 4) | _integBits);
 
 }
 
@@ -525,17 +998,28 @@ uint16_t SparkFun_Ambient_Light::_calculateBits(uint32_t _luxVal){
 void SparkFun_Ambient_Light::_writeRegister(uint8_t _wReg, uint16_t _mask,\
                                             uint16_t _bits, uint8_t _startPosition)
 {
+
+  _lockBus();
+  _modifyRegister(_wReg, _mask, _bits, _startPosition);
+  _unlockBus();
+
+}
+
+// Same as above without taking the lock, for callers that already hold it. 
+void SparkFun_Ambient_Light::_modifyRegister(uint8_t _wReg, uint16_t _mask,\
+                                             uint16_t _bits, uint8_t _startPosition)
+{
   
   uint16_t _i2cWrite; 
 
-  _i2cWrite = _readRegister(_wReg); // Get the current value of the register
+  // Get the current value of the register. If the sensor doesn't answer
+  // fall back on the local copy rather than writing back garbage.
+  if (!_busRead(_wReg, _i2cWrite))
+    _i2cWrite = _shadow[_wReg];
   _i2cWrite &= _mask; // Mask the position we want to write to.
   _i2cWrite |= (_bits << _startPosition);  // Place the given bits to the variable
-  _i2cPort->beginTransmission(_address); // Start communication.
-  _i2cPort->write(_wReg); // at register....
-  _i2cPort->write(_i2cWrite); // Write LSB to register...
-  _i2cPort->write(_i2cWrite >> 8); // Write MSB to register...
-  _i2cPort->endTransmission(); // End communcation.
+  _setShadow(_wReg, _i2cWrite); // Remember it in case the sensor needs restoring.
+  _busWrite(_wReg, _i2cWrite);
 
 }
 
@@ -546,13 +1030,252 @@ uint16_t SparkFun_Ambient_Light::_readRegister(uint8_t _reg)
 
   uint16_t _regValue; 
 
+  _lockBus();
+  bool _ok = _busRead(_reg, _regValue);
+  _unlockBus();
+
+  if (!_ok)
+    return 0xFFFF;
+  return(_regValue);
+
+}
+
+// This function updates one register of the local copy of the configuration. 
+void SparkFun_Ambient_Light::_setShadow(uint8_t _reg, uint16_t _value)
+{
+
+  // Writers are kept apart by the bus lock, readConfig() checks the sequence
+  // count to make sure it didn't copy in the middle of this.
+  _configSeq++;
+  VEML6030_BARRIER();
+  _shadow[_reg] = _value;
+  VEML6030_BARRIER();
+  _configSeq++;
+
+}
+
+// This function copies the local copy of the configuration as is. 
+void SparkFun_Ambient_Light::_copyShadow(VEML6030_Config &_config)
+{
+
+  _config.setting = _shadow[SETTING_REG];
+  _config.highThresh = _shadow[H_THRESH_REG];
+  _config.lowThresh = _shadow[L_THRESH_REG];
+  _config.powSave = _shadow[POWER_SAVE_REG];
+
+}
+
+// These functions take and release the bus lock, if one is set. 
+void SparkFun_Ambient_Light::_lockBus()
+{
+
+  if (_lock == NULL)
+    return;
+
+  if (_lock->tryLock())
+    return;
+
+  // Someone else has the bus, time the wait. The counts are only safe to
+  // touch once the lock is held.
+  uint32_t _start = micros();
+  _lock->lock();
+  _lockContention++;
+  _lockWaitTime += micros() - _start;
+
+}
+
+void SparkFun_Ambient_Light::_unlockBus()
+{
+
+  if (_lock != NULL)
+    _lock->unlock();
+
+}
+
+// This function reads a 16 bit register into _value and returns false if
+// the sensor did not answer. 
+bool SparkFun_Ambient_Light::_busRead(uint8_t _reg, uint16_t &_value)
+{
+
+  if (!_busReady())
+    return false;
+
   _i2cPort->beginTransmission(_address); 
   _i2cPort->write(_reg); // Moves pointer to register.
-  _i2cPort->endTransmission(false); // 'False' here sends a restart message so that bus is not released
-  _i2cPort->requestFrom(_address, static_cast<uint8_t>(2)); // Two reads for 16 bit registers
-  _regValue = _i2cPort->read(); // LSB
-  _regValue |= uint16_t(_i2cPort->read()) << 8; //MSB
-  return(_regValue);
+  uint8_t _ret = _i2cPort->endTransmission(false); // 'False' here sends a restart message so that bus is not released
+  _busTransactions++;
+  _busBytes += 2; // Address and register.
+  if (_ret) {
+    _busResult(false);
+    return false;
+  }
+
+  uint8_t _count = _i2cPort->requestFrom(_address, static_cast<uint8_t>(2)); // Two reads for 16 bit registers
+  _busTransactions++;
+  _busBytes += 3; // Address and two data bytes.
+  if (_count != 2) {
+    _busResult(false);
+    return false;
+  }
+
+  _value = _i2cPort->read(); // LSB
+  _value |= uint16_t(_i2cPort->read()) << 8; //MSB
+  _busResult(true);
+  return true;
 
 }
 
+// This function writes a full 16 bit value to a register and returns false
+// if the sensor did not answer. 
+bool SparkFun_Ambient_Light::_busWrite(uint8_t _reg, uint16_t _value)
+{
+
+  if (!_busReady())
+    return false;
+
+  _i2cPort->beginTransmission(_address); // Start communication.
+  _i2cPort->write(_reg); // at register....
+  _i2cPort->write(_value); // Write LSB to register...
+  _i2cPort->write(_value >> 8); // Write MSB to register...
+  bool _ok = (_i2cPort->endTransmission() == 0); // End communcation.
+  _busTransactions++;
+  _busBytes += 4; // Address, register and two data bytes.
+  _busResult(_ok);
+  return _ok;
+
+}
+
+// This function checks if the bus may be used. While the sensor is stalled
+// it only lets a recovery attempt through once the backoff has run out. 
+bool SparkFun_Ambient_Light::_busReady()
+{
+
+  if (!_recoveryEnabled || _failCount < VEML6030_FAIL_LIMIT)
+    return true;
+
+  if ((millis() - _lastRecovery) < _backoff)
+    return false;
+
+  return _recover();
+
+}
+
+// This function records the outcome of a transaction for the health monitor. 
+void SparkFun_Ambient_Light::_busResult(bool _ok)
+{
+
+  if (_ok)
+    _failCount = 0;
+  else if (_failCount < 0xFF)
+    _failCount++;
+
+}
+
+// This function clears a stuck bus by clocking SCL until the sensor
+// releases SDA and then sending a stop condition. Does nothing without
+// VEML6030_HAS_WIRE_END. 
+void SparkFun_Ambient_Light::_clearBus()
+{
+
+  if (_sdaPin == VEML6030_NO_PIN || _sclPin == VEML6030_NO_PIN)
+    return;
+
+#ifdef VEML6030_HAS_WIRE_END
+
+  // Take the pins back from the I2C peripheral, while it's enabled it
+  // overrides whatever is done to them here (TWEN on AVR for example).
+  _i2cPort->end();
+
+  // The lines are open drain: drive them low or let the pull-ups take them
+  // high, never drive them high.
+  pinMode(_sdaPin, INPUT_PULLUP);
+  pinMode(_sclPin, INPUT_PULLUP);
+  delayMicroseconds(5);
+
+  // A sensor stuck mid byte holds SDA low until it has clocked out the rest
+  // of it, which takes at most nine clocks.
+  for (uint8_t _clk = 0; _clk < 9 && digitalRead(_sdaPin) == LOW; _clk++) {
+    digitalWrite(_sclPin, LOW);
+    pinMode(_sclPin, OUTPUT);
+    delayMicroseconds(5);
+    pinMode(_sclPin, INPUT_PULLUP);
+    delayMicroseconds(5);
+  }
+
+  // Stop condition: SDA goes from low to high while SCL is high.
+  digitalWrite(_sdaPin, LOW);
+  pinMode(_sdaPin, OUTPUT);
+  delayMicroseconds(5);
+  pinMode(_sdaPin, INPUT_PULLUP);
+  delayMicroseconds(5);
+
+  // Hand the pins back to the I2C peripheral. This resets the bus clock on
+  // most cores, so set it again if the sketch told us what it was.
+  _i2cPort->begin();
+  if (_busClock != 0)
+    _i2cPort->setClock(_busClock);
+#endif
+
+}
+
+// This function writes the local copy of the configuration back to the
+// sensor and powers it up if it was powered before. 
+bool SparkFun_Ambient_Light::_restoreConfig()
+{
+
+  // Goes straight to the bus, _busWrite() would re-enter the recovery.
+  for (uint8_t _reg = H_THRESH_REG; _reg <= POWER_SAVE_REG; _reg++) {
+    _i2cPort->beginTransmission(_address);
+    _i2cPort->write(_reg);
+    _i2cPort->write(_shadow[_reg]);
+    _i2cPort->write(_shadow[_reg] >> 8);
+    _busTransactions++;
+    _busBytes += 4;
+    if (_i2cPort->endTransmission())
+      return false;
+  }
+
+  // The settings register goes last since it holds the shut down bit.
+  _i2cPort->beginTransmission(_address);
+  _i2cPort->write(SETTING_REG);
+  _i2cPort->write(_shadow[SETTING_REG]);
+  _i2cPort->write(_shadow[SETTING_REG] >> 8);
+  _busTransactions++;
+  _busBytes += 4;
+  if (_i2cPort->endTransmission())
+    return false;
+
+  if (!(_shadow[SETTING_REG] & ~SD_MASK))
+    delay(4); // Same power up time as powerOn().
+
+  return true;
+
+}
+
+// This function attempts a bus recovery and updates the backoff and
+// recovery statistics. 
+bool SparkFun_Ambient_Light::_recover()
+{
+
+  // A bus clear takes around a hundred microseconds, too short for millis().
+  uint32_t _start = micros();
+
+  _recoveryCount++;
+  _clearBus();
+  bool _ok = _restoreConfig();
+
+  _recoveryTime += micros() - _start;
+  _lastRecovery = millis();
+
+  if (_ok) {
+    _failCount = 0;
+    _backoff = VEML6030_BACKOFF_MIN;
+  }
+  else if (_backoff < VEML6030_BACKOFF_MAX / 2)
+    _backoff *= 2;
+  else
+    _backoff = VEML6030_BACKOFF_MAX;
+
+  return _ok;
+
+}
@@ -3,6 +3,13 @@
 
 #include <Wire.h>
 #include <Arduino.h>
+#include "SparkFun_VEML6030_Lock.h"
+
+// Uncomment to build the library without any floating point, saving the
+// flash and time the floating point routines cost on boards without an FPU.
+// The gain is then set and read with the VEML6030_GAIN values below, and the
+// lux conversion and compensation are done in integer math.
+//#define VEML6030_NO_FLOAT
 
 #define ENABLE        0x01
 #define DISABLE       0x00
@@ -13,6 +20,42 @@
 #define INT_LOW       0x02
 #define UNKNOWN_ERROR 0xFF
 
+// Bus health monitor settings. After VEML6030_FAIL_LIMIT consecutive failed
+// transactions the sensor is considered stalled and, if bus recovery is
+// enabled, the bus is cleared and the sensor re-initialized. Failed recovery
+// attempts back off exponentially between the minimum and maximum (ms) so that
+// one dead sensor can't starve the rest of the bus. 
+#ifndef VEML6030_FAIL_LIMIT
+#define VEML6030_FAIL_LIMIT   3
+#endif
+#ifndef VEML6030_BACKOFF_MIN
+#define VEML6030_BACKOFF_MIN  100
+#endif
+#ifndef VEML6030_BACKOFF_MAX
+#define VEML6030_BACKOFF_MAX  30000
+#endif
+#define VEML6030_NO_PIN       0xFF
+
+// Cores whose Wire has end(), which the bus clear needs to take the pins back
+// from the I2C peripheral. Define it before including the library to enable
+// the bus clear on other cores that have it.
+#if !defined(VEML6030_HAS_WIRE_END) && (defined(ARDUINO_ARCH_AVR) || \
+    defined(ARDUINO_ARCH_MEGAAVR) || defined(ARDUINO_ARCH_SAMD) || \
+    defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_MBED) || \
+    defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_ARCH_STM32))
+#define VEML6030_HAS_WIRE_END
+#endif
+
+// Highest reading the sensor can give in milli-lux: a full count at a gain of
+// 1/8 and 25ms.
+#define VEML6030_MAX_MILLI_LUX 120796032UL
+
+// Number of times readConfig() tries to copy the settings on its own before
+// it waits for the bus lock instead.
+#ifndef VEML6030_SNAPSHOT_TRIES
+#define VEML6030_SNAPSHOT_TRIES 8
+#endif
+
 // 7-Bit address options
 const uint8_t defAddr = 0x48;
 const uint8_t altAddr = 0x10;
@@ -55,6 +98,17 @@ enum REGISTER_BIT_POSITIONS {
 
 };
 
+// Gain settings, the values are the register's gain bits. 
+enum VEML6030_GAIN {
+
+  VEML6030_GAIN_1        = 0x00,
+  VEML6030_GAIN_2        = 0x01,
+  VEML6030_GAIN_1_8      = 0x02,
+  VEML6030_GAIN_1_4      = 0x03
+
+};
+
+#ifndef VEML6030_NO_FLOAT
 // Table of lux conversion values depending on the integration time and gain. 
 // The arrays represent the all possible integration times and the index of the
 // arrays represent the register's gain settings, which is directly analgous to
@@ -65,6 +119,17 @@ const float twoHIt[]       = {.0144, .0288, .1152, .2304};
 const float oneHIt[]       = {.0288, .0576, .2304, .4608};
 const float fiftyIt[]      = {.0576, .1152, .4608, .9216};
 const float twentyFiveIt[] = {.1152, .2304, .9216, 1.8432};
+#endif
+
+// Copy of the sensor's writable registers as last written by the library.
+struct VEML6030_Config {
+
+  uint16_t setting;    // REG0x00
+  uint16_t highThresh; // REG0x01
+  uint16_t lowThresh;  // REG0x02
+  uint16_t powSave;    // REG0x03
+
+};
 
 class SparkFun_Ambient_Light
 {  
@@ -79,14 +144,25 @@ class SparkFun_Ambient_Light
     // are 1/8, 1/4, 1, and 2. The highest setting should only be used if the
     // sensors is behind dark glass, where as the lowest setting should be used in
     // dark rooms. The datasheet suggests always leaving it at around 1/4 or 1/8.
+#ifndef VEML6030_NO_FLOAT
     void setGain(float gainVal);
+#endif
+
+    // REG0x00, bits [12:11]
+    // Same as above, taking one of the VEML6030_GAIN values. 
+    void setGain(VEML6030_GAIN gainVal);
 
     // REG0x00, bits [12:11]
     // This function reads the gain for the Ambient Light Sensor. Possible values
     // are 1/8, 1/4, 1, and 2. The highest setting should only be used if the
     // sensors is behind dark glass, where as the lowest setting should be used in
     // dark rooms. The datasheet suggests always leaving it at around 1/4 or 1/8.
+    // Without floating point it returns one of the VEML6030_GAIN values. 
+#ifndef VEML6030_NO_FLOAT
     float readGain();
+#else
+    VEML6030_GAIN readGain();
+#endif
 
     // REG0x00, bits[9:6]
     // This function sets the integration time (the saturation time of light on the
@@ -199,39 +275,255 @@ class SparkFun_Ambient_Light
     // value exceeds 1000 then a compensation formula is applied to it. 
     uint32_t readWhiteLight();
 
+    // REG[0x04], bits[15:0]
+    // Same as readLight() but in milli-lux, with the conversion and
+    // compensation done in integer math. Compensated values too large for
+    // milli-lux (from around 50,000 lux) are capped at 0xFFFFFFFF. 
+    uint32_t readLightMilli();
+
+    // REG[0x05], bits[15:0]
+    // Same as readWhiteLight() but in milli-lux, with the conversion and
+    // compensation done in integer math. Capped the same as above. 
+    uint32_t readWhiteLightMilli();
+
+    // This function enables the bus health monitor's recovery. Once the sensor
+    // fails VEML6030_FAIL_LIMIT transactions in a row, SCL is clocked until the
+    // sensor lets go of SDA and the sensor is re-initialized with its last known
+    // configuration (gain, integration time, thresholds and power save mode).
+    // The SDA and SCL pins are optional, without them only the re-init is done. 
+    // Clearing the bus restarts the I2C port, which resets its clock on most
+    // cores, so pass the clock set with setClock() to have it set again. The
+    // bus is only cleared on cores with VEML6030_HAS_WIRE_END (AVR, megaAVR,
+    // SAMD, ESP32, mbed, RP2040 and STM32), elsewhere only the re-init is done. 
+    void enableBusRecovery(uint8_t sdaPin = VEML6030_NO_PIN, uint8_t sclPin = VEML6030_NO_PIN,
+                           uint32_t busClock = 0);
+
+    // This function disables the bus health monitor's recovery. Failures are
+    // still counted. 
+    void disableBusRecovery();
+
+    // This function clears the bus and re-initializes the sensor right away,
+    // regardless of the backoff. Returns true if the sensor answered. 
+    bool recover();
+
+    // This function checks if the sensor has failed fewer than
+    // VEML6030_FAIL_LIMIT transactions in a row. 
+    bool isHealthy();
+
+    // This function returns the number of consecutive failed transactions. 
+    uint8_t getFailCount();
+
+    // This function returns the number of recoveries attempted so far. 
+    uint16_t getRecoveryCount();
+
+    // This function returns the total time spent recovering in microseconds. 
+    uint32_t getRecoveryTime();
+
+    // This function sets the lock that is taken around every sequence of bus
+    // transactions, needed when several tasks or cores use the sensor. Sensors
+    // on the same I2C port should share one lock. 
+    void setLock(VEML6030_Lock &lock);
+
+    // This function copies the sensor's configuration as last written by the
+    // library. It doesn't touch the bus, and never returns a half updated
+    // configuration. It only waits for the lock if a write keeps getting in
+    // the way VEML6030_SNAPSHOT_TRIES times, for example because the caller
+    // preempted the task that was writing. Don't call it from an interrupt. 
+    void readConfig(VEML6030_Config &config);
+
+    // This function returns how many times the lock was already taken when
+    // the sensor needed it. 
+    uint32_t getLockContention();
+
+    // This function returns the total time spent waiting for the lock in
+    // microseconds. 
+    uint32_t getLockWaitTime();
+
+    // This function returns the number of I2C transactions (every start
+    // condition, repeated or not) since the last resetBusStats(). Reading a
+    // register takes two, writing one takes one. 
+    uint32_t getBusTransactions();
+
+    // This function returns the number of bytes put on the bus, address bytes
+    // included, since the last resetBusStats(). 
+    uint32_t getBusBytes();
+
+    // This function clears the transaction and byte counts. 
+    void resetBusStats();
+
+    // This function returns the raw count of the last successful readLight(),
+    // without touching the bus. 
+    uint16_t getLastRawLight();
+
+    // This function returns the settings tag the last successful readLight()
+    // was taken under: the gain bits in [5:4] and the integration time bits in
+    // [3:0]. Together with the raw count it pins down the lux value. 
+    uint8_t getLastSettingsTag();
+
+    // This function returns the settings tag the sensor is set to now, as last
+    // written by the library, without touching the bus. 
+    uint8_t getSettingsTag();
+
+    // This function returns the number of successful readLight() calls, so
+    // that new samples can be told apart from ones already seen. 
+    uint32_t getSampleCount();
+
+    // This function returns the lux per count for a settings tag, in units of
+    // 0.1 milli-lux, or 0 for an invalid tag. Same values as the tables above. 
+    static uint16_t luxResolution(uint8_t settingsTag);
+
+    // This function applies the datasheet's compensation for readings over
+    // 1000 lux to a lux value, the same way readLight() does. Values past the
+    // sensor's highest reading are treated as that reading. 
+    static uint32_t compensateLux(uint32_t luxVal);
+
   private:
 
     uint8_t _address;
+
+    // Local copy of REG0x00 - REG0x03, indexed by register address. Every write
+    // goes through here first so that the sensor can be restored after a
+    // recovery without re-deriving its settings. 
+    uint16_t _shadow[4];
+
+    // Sequence count of the local copy above. It's odd while the copy is being
+    // updated so that readers can tell when to try again. 
+    volatile uint16_t _configSeq;
+
+    // Bus lock state. 
+    VEML6030_Lock *_lock;
+    uint32_t _lockContention;
+    uint32_t _lockWaitTime;
+
+    // Bus usage counts. 
+    uint32_t _busTransactions;
+    uint32_t _busBytes;
+
+    // Last successful ambient light sample. 
+    uint16_t _lastRaw;
+    uint8_t _lastTag;
+    uint32_t _sampleCount;
+
+    // Bus health monitor state. 
+    bool _recoveryEnabled;
+    uint8_t _sdaPin;
+    uint8_t _sclPin;
+    uint32_t _busClock;
+    uint8_t _failCount;
+    uint16_t _recoveryCount;
+    uint32_t _recoveryTime;
+    uint32_t _lastRecovery;
+    uint32_t _backoff;
     
     // This function compensates for lux values over 1000. From datasheet:
     // "Illumination values higher than 1000 lx show non-linearity. This
     // non-linearity is the same for all sensors, so a compensation forumla..."
     // etc. etc. 
-    uint32_t _luxCompensation(uint32_t _luxVal);
+    static uint32_t _luxCompensation(uint32_t _luxVal);
+
+    // Same as above in milli-lux, in integer math. Values past the sensor's
+    // highest reading are treated as that reading. Past roughly 50,000 lux
+    // the result no longer fits 32 bits. 
+    static uint64_t _milliLuxCompensation(uint32_t _milliLux);
+
+    // These functions take the gain and integration time out of a value of the
+    // settings register. 
+#ifndef VEML6030_NO_FLOAT
+    float _decodeGain(uint16_t _setting);
+#endif
+    uint16_t _decodeIntegTime(uint16_t _setting);
+
+    // This function packs the gain and integration time bits of a value of the
+    // settings register into a settings tag. 
+    static uint8_t _settingsTag(uint16_t _setting);
+
+    // This function reads one of the light data registers and converts it to
+    // lux with the settings it was taken under. 
+    uint32_t _readLux(uint8_t _reg);
+
+    // Same as above but in milli-lux, in integer math. 
+    uint32_t _readMilliLux(uint8_t _reg);
+
+    // This function reads one of the light data registers, keeping the sample
+    // when it is the ambient light, and hands back the settings it was taken
+    // under. 
+    uint16_t _readLightBits(uint8_t _reg, uint16_t &_setting);
+
+    // This function reads one of the threshold registers and converts it to
+    // lux with the current settings. 
+    uint32_t _readThresh(uint8_t _reg);
+
+    // This function converts a lux value to bits with the current settings
+    // and writes it to one of the threshold registers. 
+    void _writeThresh(uint8_t _reg, uint32_t _luxVal);
 
     // The lux value of the Ambient Light sensor depends on both the gain and the
     // integration time settings. This function determines which conversion value
     // to use by using the bit representation of the gain as an index to look up
     // the conversion value in the correct integration time array. It then converts 
     // the value and returns it.  
-    uint32_t _calculateLux(uint16_t _lightBits);
+    uint32_t _calculateLux(uint16_t _lightBits, uint16_t _setting);
+
+    // Same as above but in milli-lux, in integer math. 
+    uint32_t _calculateMilliLux(uint16_t _lightBits, uint16_t _setting);
 
     // This function does the opposite calculation then the function above. The interrupt
     // threshold values given by the user are dependent on the gain and
     // intergration time settings. As a result the lux value needs to be
     // calculated with the current settings and this function accomplishes
     // that.  
-    uint16_t _calculateBits(uint32_t _luxVal);
+    uint16_t _calculateBits(uint32_t _luxVal, uint16_t _setting);
 
     // This function writes to a 16 bit register. Paramaters include the register's address, a mask 
     // for bits that are ignored, the bits to write, and the bits' starting
     // position.
     void _writeRegister(uint8_t _wReg, uint16_t _mask, uint16_t _bits, uint8_t _startPosition);
 
+    // Same as above without taking the lock, for callers that already hold it. 
+    void _modifyRegister(uint8_t _wReg, uint16_t _mask, uint16_t _bits, uint8_t _startPosition);
+
+    // This function updates one register of the local copy of the configuration. 
+    void _setShadow(uint8_t _reg, uint16_t _value);
+
+    // This function copies the local copy of the configuration as is. 
+    void _copyShadow(VEML6030_Config &_config);
+
+    // These functions take and release the bus lock, if one is set. 
+    void _lockBus();
+    void _unlockBus();
+
     // This function reads a 16 bit register. It takes the register's
     // address as its' parameter.
     uint16_t _readRegister(uint8_t _reg);
 
+    // This function reads a 16 bit register into _value and returns false if
+    // the sensor did not answer. 
+    bool _busRead(uint8_t _reg, uint16_t &_value);
+
+    // This function writes a full 16 bit value to a register and returns false
+    // if the sensor did not answer. 
+    bool _busWrite(uint8_t _reg, uint16_t _value);
+
+    // This function checks if the bus may be used. While the sensor is stalled
+    // it only lets a recovery attempt through once the backoff has run out. 
+    bool _busReady();
+
+    // This function records the outcome of a transaction for the health monitor. 
+    void _busResult(bool _ok);
+
+    // This function clears a stuck bus by clocking SCL until the sensor
+    // releases SDA and then sending a stop condition. Does nothing without
+    // VEML6030_HAS_WIRE_END. 
+    void _clearBus();
+
+    // This function writes the local copy of the configuration back to the
+    // sensor and powers it up if it was powered before. 
+    bool _restoreConfig();
+
+    // This function attempts a bus recovery and updates the backoff and
+    // recovery statistics. 
+    bool _recover();
+
     TwoWire *_i2cPort;
 };
 #endif
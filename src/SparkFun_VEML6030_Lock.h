@@ -0,0 +1,73 @@
+#ifndef _SPARKFUN_VEML6030_LOCK_H_
+#define _SPARKFUN_VEML6030_LOCK_H_
+
+#include <Arduino.h>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#define VEML6030_HAS_RTOS
+#elif defined(INC_FREERTOS_H)
+// FreeRTOS was included by the sketch before this library.
+#include <task.h>
+#include <semphr.h>
+#define VEML6030_HAS_RTOS
+#endif
+
+// Memory barrier for the settings snapshot. On AVR a compiler barrier is
+// enough, everything else gets a full hardware barrier for multi-core targets.
+#if defined(__AVR__)
+#define VEML6030_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define VEML6030_BARRIER() __sync_synchronize()
+#endif
+
+// Lock taken around every sequence of bus transactions that has to happen as
+// one, for example the read-modify-write of a register. Sensors sharing an I2C
+// port should share a lock.
+class VEML6030_Lock
+{
+  public:
+
+    // This function takes the lock if it is free and returns true, otherwise
+    // it returns false right away.
+    virtual bool tryLock() = 0;
+
+    // This function waits until the lock is free and takes it.
+    virtual void lock() = 0;
+
+    // This function releases the lock.
+    virtual void unlock() = 0;
+};
+
+// No locking at all, the same as not setting a lock. For single threaded
+// sketches.
+class VEML6030_NoLock : public VEML6030_Lock
+{
+  public:
+
+    bool tryLock() { return true; }
+    void lock() {}
+    void unlock() {}
+};
+
+#ifdef VEML6030_HAS_RTOS
+// FreeRTOS mutex for sketches where several tasks, possibly on different
+// cores, use the sensor.
+class VEML6030_Mutex : public VEML6030_Lock
+{
+  public:
+
+    VEML6030_Mutex() { _mutex = xSemaphoreCreateMutex(); }
+    bool tryLock() { return (xSemaphoreTake(_mutex, 0) == pdTRUE); }
+    void lock() { xSemaphoreTake(_mutex, portMAX_DELAY); }
+    void unlock() { xSemaphoreGive(_mutex); }
+
+  private:
+
+    SemaphoreHandle_t _mutex;
+};
+#endif
+
+#endif
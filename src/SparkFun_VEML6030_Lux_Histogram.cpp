@@ -0,0 +1,174 @@
+/*
+  This is a library for SparkFun's VEML6030 Ambient Light Sensor (Qwiic)
+  By: SparkFun Electronics
+  Date: October 2026
+  License: This code is public domain but you buy me a beer if you use this and
+  we meet someday (Beerware license).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+ */
+
+#include "SparkFun_VEML6030_Lux_Histogram.h"
+
+VEML6030_Lux_Histogram::VEML6030_Lux_Histogram()
+{
+
+  rotate();
+
+}
+
+// This function adds a reading. It takes the raw count and the settings
+// tag it was taken under, as given by getLastRawLight() and
+// getLastSettingsTag(). Readings with an invalid tag are ignored.
+// Those keep the last good reading when a read fails, so only insert
+// once getSampleCount() has moved on since the last insert.
+void VEML6030_Lux_Histogram::insert(uint16_t rawLight, uint8_t settingsTag){
+
+  uint16_t _res = SparkFun_Ambient_Light::luxResolution(settingsTag);
+  if (_res == 0)
+    return;
+
+  // Resolution is in 0.1 milli-lux.
+  uint32_t _milliLux = (static_cast<uint32_t>(rawLight) * _res) / 10;
+  uint8_t _bin = _binOf(_milliLux);
+
+  // Rather than letting a bin overflow, halve every bin. This keeps the shape
+  // of the distribution and so the percentiles.
+  if (_bins[_bin] == 0xFFFF)
+    rotate(1);
+
+  _bins[_bin]++;
+  _total++;
+
+}
+
+// This function returns the lux value below which the given percentage
+// (0-100) of the readings fall, with the same compensation as readLight().
+// The value is the middle of the bin it falls in, compensated afterwards,
+// see the header for how far off that can be. Returns 0 when empty.
+uint32_t VEML6030_Lux_Histogram::percentile(uint8_t pct){
+
+  if (_total == 0)
+    return 0;
+
+  if (pct > 100)
+    pct = 100;
+
+  // Rank of the reading we're after, at least the first one.
+  uint32_t _rank = (_total * pct + 99) / 100;
+  if (_rank == 0)
+    _rank = 1;
+
+  uint32_t _seen = 0;
+  uint8_t _bin;
+  for (_bin = 0; _bin < VEML6030_HIST_BINS - 1; _bin++) {
+    _seen += _bins[_bin];
+    if (_seen >= _rank)
+      break;
+  }
+
+  // The last bin ends where the next one would start, past the sensor's
+  // range, so cap its middle to the highest reading.
+  uint32_t _low = binLowerBound(_bin);
+  uint32_t _high = binLowerBound(_bin + 1);
+  uint32_t _milliLux = _low + ((_high - _low) / 2);
+  if (_milliLux > VEML6030_HIST_MAX_MILLI_LUX)
+    _milliLux = VEML6030_HIST_MAX_MILLI_LUX;
+
+  // The compensation only moves values up, so applying it after picking the
+  // bin gives the same answer as binning compensated values.
+  return SparkFun_Ambient_Light::compensateLux(_milliLux / 1000);
+
+}
+
+// This function returns the number of readings in the window.
+uint32_t VEML6030_Lux_Histogram::count(){
+
+  return _total;
+
+}
+
+// This function starts a new window. With keepShift of 0 the old readings
+// are dropped, otherwise their weight is divided by 2^keepShift so that
+// older windows fade out gradually.
+void VEML6030_Lux_Histogram::rotate(uint8_t keepShift){
+
+  _total = 0;
+  for (uint8_t _bin = 0; _bin < VEML6030_HIST_BINS; _bin++) {
+    if (keepShift == 0 || keepShift > 15)
+      _bins[_bin] = 0;
+    else
+      _bins[_bin] >>= keepShift;
+    _total += _bins[_bin];
+  }
+
+}
+
+// This function writes a compact snapshot of the histogram to buf and
+// returns the number of bytes written, or 0 if size is too small.
+uint16_t VEML6030_Lux_Histogram::serialize(uint8_t *buf, uint16_t size){
+
+  uint16_t _len = 3;
+  if (size < _len)
+    return 0;
+
+  buf[0] = VEML6030_HIST_VERSION;
+  buf[1] = VEML6030_HIST_SUB_BITS;
+  buf[2] = 0;
+
+  for (uint8_t _bin = 0; _bin < VEML6030_HIST_BINS; _bin++) {
+    if (_bins[_bin] == 0)
+      continue;
+    if (size < _len + 3)
+      return 0;
+    buf[_len++] = _bin;
+    buf[_len++] = _bins[_bin]; // LSB
+    buf[_len++] = _bins[_bin] >> 8; // MSB
+    buf[2]++;
+  }
+
+  return _len;
+
+}
+
+// This function returns the lowest uncompensated milli-lux value that
+// falls in a bin.
+uint32_t VEML6030_Lux_Histogram::binLowerBound(uint8_t bin){
+
+  const uint8_t _subCount = 1 << VEML6030_HIST_SUB_BITS;
+
+  // The first bins are one milli-lux wide.
+  if (bin < _subCount)
+    return bin;
+
+  uint8_t _exp = (bin >> VEML6030_HIST_SUB_BITS) - 1;
+  uint32_t _mantissa = _subCount | (bin & (_subCount - 1));
+  return (_mantissa << _exp);
+
+}
+
+// This function returns the bin an uncompensated milli-lux value falls in.
+uint8_t VEML6030_Lux_Histogram::_binOf(uint32_t _milliLux){
+
+  const uint8_t _subCount = 1 << VEML6030_HIST_SUB_BITS;
+
+  if (_milliLux < _subCount)
+    return _milliLux;
+
+  // Find the highest set bit, the top VEML6030_HIST_SUB_BITS bits below it
+  // pick the bin within that doubling.
+  uint32_t _val = _milliLux;
+  uint8_t _msb = 0;
+  if (_val >= 0x10000) { _val >>= 16; _msb += 16; }
+  if (_val >= 0x100) { _val >>= 8; _msb += 8; }
+  if (_val >= 0x10) { _val >>= 4; _msb += 4; }
+  if (_val >= 0x4) { _val >>= 2; _msb += 2; }
+  if (_val >= 0x2) { _msb += 1; }
+
+  uint8_t _exp = _msb - VEML6030_HIST_SUB_BITS;
+  uint16_t _bin = ((_exp + 1) << VEML6030_HIST_SUB_BITS) | ((_milliLux >> _exp) & (_subCount - 1));
+  if (_bin >= VEML6030_HIST_BINS)
+    _bin = VEML6030_HIST_BINS - 1;
+  return _bin;
+
+}
@@ -0,0 +1,91 @@
+#ifndef _SPARKFUN_VEML6030_LUX_HISTOGRAM_H_
+#define _SPARKFUN_VEML6030_LUX_HISTOGRAM_H_
+
+#include <Arduino.h>
+#include "SparkFun_VEML6030_Ambient_Light_Sensor.h"
+
+// Number of bins per doubling of lux is 2^VEML6030_HIST_SUB_BITS. The default
+// of 2 gives bins at most 25% wide and 104 bins (208 bytes) per histogram, 3
+// gives bins at most 12.5% wide and 200 bins (400 bytes). Widths are before
+// the compensation above 1000 lux, see percentile().
+#ifndef VEML6030_HIST_SUB_BITS
+#define VEML6030_HIST_SUB_BITS 2
+#endif
+
+// Values are binned in milli-lux, the sensor's highest reading is just under
+// 2^27 milli-lux.
+#define VEML6030_HIST_VALUE_BITS 27
+#define VEML6030_HIST_BINS ((VEML6030_HIST_VALUE_BITS - VEML6030_HIST_SUB_BITS + 1) << VEML6030_HIST_SUB_BITS)
+
+// Bins are indexed with a byte, in memory and in serialized snapshots.
+#if VEML6030_HIST_BINS > 255
+#error "VEML6030_HIST_SUB_BITS is too large, there can be at most 255 bins"
+#endif
+
+// Highest reading the sensor is specified for, in milli-lux. Percentiles are
+// capped to it before they are compensated.
+#define VEML6030_HIST_MAX_MILLI_LUX 120000000UL
+
+// First byte of a serialized snapshot.
+#define VEML6030_HIST_VERSION 0x01
+
+// Streaming lux histogram with log spaced bins over the sensor's full range,
+// for percentiles over a window of readings without keeping the readings
+// themselves. Fixed memory, one per sensor.
+class VEML6030_Lux_Histogram
+{
+  public:
+
+    VEML6030_Lux_Histogram();
+
+    // This function adds a reading. It takes the raw count and the settings
+    // tag it was taken under, as given by getLastRawLight() and
+    // getLastSettingsTag(). Readings with an invalid tag are ignored.
+    // Those keep the last good reading when a read fails, so only insert
+    // once getSampleCount() has moved on since the last insert.
+    void insert(uint16_t rawLight, uint8_t settingsTag);
+
+    // This function returns the lux value below which the given percentage
+    // (0-100) of the readings fall, with the same compensation as readLight().
+    // The value is the middle of the bin it falls in, compensated afterwards.
+    // The compensation stretches the bins above 1000 lux, so how far the value
+    // can be from the readings in its bin grows with the light level. With
+    // VEML6030_HIST_SUB_BITS of 2 (3):
+    //   below 8,400 lux       13% (7%), 15% (10%) in the bin around 1000 lux
+    //   8,400 - 16,800 lux    19% (9%)
+    //   16,800 - 33,600 lux   42% (19%)
+    //   above 33,600 lux      59% (27%)
+    // Returns 0 when empty.
+    uint32_t percentile(uint8_t pct);
+
+    // This function returns the number of readings in the window.
+    uint32_t count();
+
+    // This function starts a new window. With keepShift of 0 the old readings
+    // are dropped, otherwise their weight is divided by 2^keepShift so that
+    // older windows fade out gradually.
+    void rotate(uint8_t keepShift = 0);
+
+    // This function writes a compact snapshot of the histogram to buf and
+    // returns the number of bytes written, or 0 if size is too small. Only
+    // bins holding readings are written:
+    //   byte 0      VEML6030_HIST_VERSION
+    //   byte 1      VEML6030_HIST_SUB_BITS
+    //   byte 2      number of bins that follow
+    //   3 bytes     per bin: bin index, then its count as 16 bit LSB first
+    // Use binLowerBound() to turn a bin index back into milli-lux.
+    uint16_t serialize(uint8_t *buf, uint16_t size);
+
+    // This function returns the lowest uncompensated milli-lux value that
+    // falls in a bin.
+    static uint32_t binLowerBound(uint8_t bin);
+
+  private:
+
+    uint16_t _bins[VEML6030_HIST_BINS];
+    uint32_t _total;
+
+    // This function returns the bin an uncompensated milli-lux value falls in.
+    uint8_t _binOf(uint32_t _milliLux);
+};
+#endif
@@ -0,0 +1,259 @@
+/*
+  This is a library for SparkFun's VEML6030 Ambient Light Sensor (Qwiic)
+  By: SparkFun Electronics
+  Date: October 2026
+  License: This code is public domain but you buy me a beer if you use this and
+  we meet someday (Beerware license).
+
+  Feel like supporting our work? Buy a board from SparkFun!
+ */
+
+#include "SparkFun_VEML6030_Threshold_Engine.h"
+
+VEML6030_Threshold_Engine::VEML6030_Threshold_Engine()
+{
+
+  _watchCount = 0;
+  _eventCount = 0;
+  _dropped = 0;
+  _missed = 0;
+  _skipped = 0;
+  _handler = NULL;
+
+}
+
+// This function adds a sensor that is checked in software. The thresholds
+// are raw counts, so they only hold for the gain and integration time the
+// sensor is set to now. Returns the sensor's index, or UNKNOWN_ERROR if the
+// engine is full.
+uint8_t VEML6030_Threshold_Engine::addSensor(SparkFun_Ambient_Light &sensor, uint16_t lowThresh,
+                                             uint16_t highThresh, uint8_t protVal){
+
+  if (_watchCount >= VEML6030_MAX_SENSORS)
+    return UNKNOWN_ERROR;
+
+  _Watch &_watch = _watches[_watchCount];
+  _watch.sensor = &sensor;
+  _watch.lastSample = sensor.getSampleCount(); // Only readings from now on.
+  _watch.lowThresh = lowThresh;
+  _watch.highThresh = highThresh;
+  _watch.settingsTag = sensor.getSettingsTag();
+  _watch.protVal = 1;
+  _watch.highCount = 0;
+  _watch.lowCount = 0;
+  _watch.intPin = VEML6030_NO_PIN;
+
+  uint8_t _index = _watchCount++;
+  setProtect(_index, protVal);
+  return _index;
+
+}
+
+// This function adds a sensor with its INT pin wired to intPin. Returns the
+// sensor's index, or UNKNOWN_ERROR if the engine is full.
+uint8_t VEML6030_Threshold_Engine::addSensorInt(SparkFun_Ambient_Light &sensor, uint8_t intPin){
+
+  if (_watchCount >= VEML6030_MAX_SENSORS)
+    return UNKNOWN_ERROR;
+
+  _Watch &_watch = _watches[_watchCount];
+  _watch.sensor = &sensor;
+  _watch.lastSample = 0;
+  _watch.lowThresh = 0;
+  _watch.highThresh = 0;
+  _watch.settingsTag = 0;
+  _watch.protVal = 1;
+  _watch.highCount = 0;
+  _watch.lowCount = 0;
+  _watch.intPin = intPin;
+
+  // The INT pin is open drain and active low.
+  pinMode(intPin, INPUT_PULLUP);
+
+  return _watchCount++;
+
+}
+
+// This function changes the thresholds of a sensor checked in software,
+// for the gain and integration time the sensor is set to now.
+void VEML6030_Threshold_Engine::setThresh(uint8_t index, uint16_t lowThresh, uint16_t highThresh){
+
+  if (index >= _watchCount)
+    return;
+
+  _watches[index].lowThresh = lowThresh;
+  _watches[index].highThresh = highThresh;
+  _watches[index].settingsTag = _watches[index].sensor->getSettingsTag();
+  _watches[index].highCount = 0;
+  _watches[index].lowCount = 0;
+
+}
+
+// This function changes the persistence protect number of a sensor
+// checked in software. Takes 1, 2, 4 or 8.
+void VEML6030_Threshold_Engine::setProtect(uint8_t index, uint8_t protVal){
+
+  if (index >= _watchCount)
+    return;
+
+  if (protVal != 1 && protVal != 2 && protVal != 4 && protVal != 8)
+    return;
+
+  _watches[index].protVal = protVal;
+  _watches[index].highCount = 0;
+  _watches[index].lowCount = 0;
+
+}
+
+// This function sets the function update() hands its events to. Without
+// one, events are kept until collected with readEvents().
+void VEML6030_Threshold_Engine::onEvents(VEML6030_EventHandler handler){
+
+  _handler = handler;
+
+}
+
+// This function checks every sensor that has a new reading since the last
+// update, or a low INT pin, and returns the number of events found.
+uint8_t VEML6030_Threshold_Engine::update(){
+
+  uint8_t _found = 0;
+
+  for (uint8_t _index = 0; _index < _watchCount; _index++) {
+
+    _Watch &_watch = _watches[_index];
+
+    // Wired sensors: the pin says if there's anything to read at all.
+    if (_watch.intPin != VEML6030_NO_PIN) {
+      if (digitalRead(_watch.intPin) == HIGH)
+        continue;
+      uint8_t _int = _watch.sensor->readInterrupt();
+      if (_int == INT_HIGH || _int == INT_LOW) {
+        _addEvent(_index, _int, 0);
+        _found++;
+      }
+      continue;
+    }
+
+    // Everything else is checked against the reading readLight() kept.
+    uint32_t _sample = _watch.sensor->getSampleCount();
+    if (_sample == _watch.lastSample)
+      continue;
+    // Only the latest reading is still there.
+    _addCount(_missed, _sample - _watch.lastSample - 1);
+    _watch.lastSample = _sample;
+
+    // A raw count taken under other settings means something else entirely,
+    // and breaks any run of readings in a row.
+    if (_watch.sensor->getLastSettingsTag() != _watch.settingsTag) {
+      _watch.highCount = 0;
+      _watch.lowCount = 0;
+      _addCount(_skipped, 1);
+      continue;
+    }
+
+    uint16_t _raw = _watch.sensor->getLastRawLight();
+
+    // Like the sensor, only readings in a row count, and the count starts
+    // over once the event has fired.
+    if (_raw > _watch.highThresh) {
+      _watch.lowCount = 0;
+      if (++_watch.highCount >= _watch.protVal) {
+        _watch.highCount = 0;
+        _addEvent(_index, INT_HIGH, _raw);
+        _found++;
+      }
+    }
+    else if (_raw < _watch.lowThresh) {
+      _watch.highCount = 0;
+      if (++_watch.lowCount >= _watch.protVal) {
+        _watch.lowCount = 0;
+        _addEvent(_index, INT_LOW, _raw);
+        _found++;
+      }
+    }
+    else {
+      _watch.highCount = 0;
+      _watch.lowCount = 0;
+    }
+
+  }
+
+  // Hand over everything found in one go.
+  if (_handler != NULL && _eventCount > 0) {
+    _handler(_events, _eventCount);
+    _eventCount = 0;
+  }
+
+  return _found;
+
+}
+
+// This function moves up to maxEvents waiting events into events and
+// returns how many it moved.
+uint8_t VEML6030_Threshold_Engine::readEvents(VEML6030_Event *events, uint8_t maxEvents){
+
+  uint8_t _moved = (maxEvents < _eventCount) ? maxEvents : _eventCount;
+
+  for (uint8_t _i = 0; _i < _moved; _i++)
+    events[_i] = _events[_i];
+
+  // Keep whatever didn't fit at the front for next time.
+  for (uint8_t _i = _moved; _i < _eventCount; _i++)
+    _events[_i - _moved] = _events[_i];
+  _eventCount -= _moved;
+
+  return _moved;
+
+}
+
+// This function returns the number of events lost because there was no
+// room left to keep them.
+uint16_t VEML6030_Threshold_Engine::getDroppedEvents(){
+
+  return _dropped;
+
+}
+
+// This function returns the number of readings that were never checked
+// because another reading of the same sensor came before update().
+uint16_t VEML6030_Threshold_Engine::getMissedSamples(){
+
+  return _missed;
+
+}
+
+// This function returns the number of readings that were not checked
+// because the sensor's gain or integration time no longer matched its
+// thresholds.
+uint16_t VEML6030_Threshold_Engine::getSkippedSamples(){
+
+  return _skipped;
+
+}
+
+// This function queues an event.
+void VEML6030_Threshold_Engine::_addEvent(uint8_t _sensor, uint8_t _type, uint16_t _rawLight){
+
+  if (_eventCount >= VEML6030_MAX_EVENTS) {
+    if (_dropped < 0xFFFF)
+      _dropped++;
+    return;
+  }
+
+  _events[_eventCount].sensor = _sensor;
+  _events[_eventCount].type = _type;
+  _events[_eventCount].rawLight = _rawLight;
+  _eventCount++;
+
+}
+
+// This function adds to one of the sample counts, stopping at its max.
+void VEML6030_Threshold_Engine::_addCount(uint16_t &_count, uint32_t _amount){
+
+  if (_amount > 0xFFFFUL - _count)
+    _count = 0xFFFF;
+  else
+    _count += _amount;
+
+}
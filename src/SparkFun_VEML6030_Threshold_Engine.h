@@ -0,0 +1,125 @@
+#ifndef _SPARKFUN_VEML6030_THRESHOLD_ENGINE_H_
+#define _SPARKFUN_VEML6030_THRESHOLD_ENGINE_H_
+
+#include <Arduino.h>
+#include "SparkFun_VEML6030_Ambient_Light_Sensor.h"
+
+// Most sensors one engine watches.
+#ifndef VEML6030_MAX_SENSORS
+#define VEML6030_MAX_SENSORS 8
+#endif
+
+// Most events held until they are delivered.
+#ifndef VEML6030_MAX_EVENTS
+#define VEML6030_MAX_EVENTS 16
+#endif
+
+// A threshold crossing on one of the engine's sensors.
+struct VEML6030_Event {
+
+  uint8_t sensor;    // Index given by addSensor() or addSensorInt()
+  uint8_t type;      // INT_HIGH or INT_LOW
+  uint16_t rawLight; // Raw count that fired it, 0 when read from the INT pin
+
+};
+
+// Called by update() with every event found during that update.
+typedef void (*VEML6030_EventHandler)(const VEML6030_Event *events, uint8_t count);
+
+// Software version of the sensor's threshold interrupt for many sensors
+// without an INT pin each. Thresholds are checked against the last reading
+// the sketch already took with readLight(), so detecting a crossing costs no
+// bus traffic at all. Sensors that do have their INT pin wired are checked
+// with the pin instead.
+//
+// Only the latest reading of each sensor is kept, so call readLight() at most
+// once per sensor between calls to update(). Readings taken in between are
+// not checked, they are counted by getMissedSamples().
+class VEML6030_Threshold_Engine
+{
+  public:
+
+    VEML6030_Threshold_Engine();
+
+    // This function adds a sensor that is checked in software. The thresholds
+    // are raw counts, so they only hold for the gain and integration time the
+    // sensor is set to now: readings taken under other settings are skipped
+    // until setThresh() is called again. The persistence protect number (1, 2, 4 or 8) works
+    // the same as setProtect(): that many readings in a row must be above the
+    // upper or below the lower threshold before an event fires. Returns the
+    // sensor's index, or UNKNOWN_ERROR if the engine is full.
+    uint8_t addSensor(SparkFun_Ambient_Light &sensor, uint16_t lowThresh,
+                      uint16_t highThresh, uint8_t protVal = 1);
+
+    // This function adds a sensor with its INT pin wired to intPin. Its
+    // thresholds, persistence and interrupt are set up on the sensor itself,
+    // see Example2. Its interrupt register is only read when the pin is low.
+    // Returns the sensor's index, or UNKNOWN_ERROR if the engine is full.
+    uint8_t addSensorInt(SparkFun_Ambient_Light &sensor, uint8_t intPin);
+
+    // This function changes the thresholds of a sensor checked in software,
+    // for the gain and integration time the sensor is set to now.
+    void setThresh(uint8_t index, uint16_t lowThresh, uint16_t highThresh);
+
+    // This function changes the persistence protect number of a sensor
+    // checked in software. Takes 1, 2, 4 or 8.
+    void setProtect(uint8_t index, uint8_t protVal);
+
+    // This function sets the function update() hands its events to. Without
+    // one, events are kept until collected with readEvents().
+    void onEvents(VEML6030_EventHandler handler);
+
+    // This function checks every sensor that has a new reading since the last
+    // update, or a low INT pin, and returns the number of events found. Call it
+    // after each pass of readLight() calls, one call per sensor.
+    uint8_t update();
+
+    // This function moves up to maxEvents waiting events into events and
+    // returns how many it moved.
+    uint8_t readEvents(VEML6030_Event *events, uint8_t maxEvents);
+
+    // This function returns the number of events lost because there was no
+    // room left to keep them.
+    uint16_t getDroppedEvents();
+
+    // This function returns the number of readings that were never checked
+    // because another reading of the same sensor came before update().
+    uint16_t getMissedSamples();
+
+    // This function returns the number of readings that were not checked
+    // because the sensor's gain or integration time no longer matched its
+    // thresholds.
+    uint16_t getSkippedSamples();
+
+  private:
+
+    struct _Watch {
+      SparkFun_Ambient_Light *sensor;
+      uint32_t lastSample;
+      uint16_t lowThresh;
+      uint16_t highThresh;
+      uint8_t settingsTag;
+      uint8_t protVal;
+      uint8_t highCount;
+      uint8_t lowCount;
+      uint8_t intPin;
+    };
+
+    _Watch _watches[VEML6030_MAX_SENSORS];
+    uint8_t _watchCount;
+
+    VEML6030_Event _events[VEML6030_MAX_EVENTS];
+    uint8_t _eventCount;
+    uint16_t _dropped;
+    uint16_t _missed;
+    uint16_t _skipped;
+
+    VEML6030_EventHandler _handler;
+
+    // This function queues an event.
+    void _addEvent(uint8_t _sensor, uint8_t _type, uint16_t _rawLight);
+
+    // This function adds to one of the sample counts, stopping at its max.
+    void _addCount(uint16_t &_count, uint32_t _amount);
+};
+#endif